@@ -0,0 +1,273 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+// Measures the encoding and decoding throughput for every value type.
+//
+// Usage: gbkf_bench [scale] [repetitions]
+//
+// The output is CSV, one line per measurement, with the best time of the repetitions:
+//      operation,type,records,records_nb,values_nb,sha,source,bytes,seconds,mb_per_s,records_per_s
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreReader.hxx"
+#include "GBKF/GBKFCoreWriter.hxx"
+
+namespace {
+
+    using AddRecord = std::function<void(GBKFCoreWriter &, uint32_t)>;
+
+    struct BenchCase {
+        std::string type_name;
+
+        // Prepares the values once, and returns the function that adds a record with them
+        std::function<AddRecord(uint32_t values_nb)> prepare;
+    };
+
+    struct RecordsShape {
+        std::string name;
+        uint32_t records_nb;
+        uint32_t values_nb;
+    };
+
+    // Keeps the results alive, so the decoding is not optimized away
+    volatile uint64_t g_sink = 0;
+
+    template<typename T>
+    std::vector<T> makeValues(const uint32_t values_nb) {
+        std::vector<T> values(values_nb);
+        for (uint32_t i = 0; i < values_nb; ++i) {
+            values[i] = static_cast<T>(i * 7 + 3);
+        }
+        return values;
+    }
+
+    std::vector<std::string> makeStrings(const uint32_t values_nb) {
+        std::vector<std::string> values(values_nb);
+        for (uint32_t i = 0; i < values_nb; ++i) {
+            values[i] = "value_" + std::to_string(i % 1000);
+        }
+        return values;
+    }
+
+    template<typename T, typename Add>
+    BenchCase makeCase(const std::string &type_name, Add add) {
+        return {type_name, [add](const uint32_t values_nb) -> AddRecord {
+            auto values = std::make_shared<std::vector<T> >(makeValues<T>(values_nb));
+            return [add, values](GBKFCoreWriter &writer, const uint32_t instance_id) {
+                add(writer, instance_id, *values);
+            };
+        }};
+    }
+
+    std::vector<BenchCase> makeCases() {
+        std::vector<BenchCase> cases;
+
+        cases.push_back(makeCase<uint8_t>("BLOB", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesBlob("K", id, v);
+        }));
+
+        cases.push_back({"BOOLEAN", [](const uint32_t values_nb) -> AddRecord {
+            auto values = std::make_shared<std::vector<bool> >(values_nb);
+            for (uint32_t i = 0; i < values_nb; ++i) {
+                (*values)[i] = i % 3 == 0;
+            }
+            return [values](GBKFCoreWriter &writer, const uint32_t id) {
+                writer.addKeyedValuesBoolean("K", id, *values);
+            };
+        }});
+
+        cases.push_back({"STRING_FIXED", [](const uint32_t values_nb) -> AddRecord {
+            auto values = std::make_shared<std::vector<std::string> >(makeStrings(values_nb));
+            return [values](GBKFCoreWriter &writer, const uint32_t id) {
+                writer.addKeyedValuesStringUTF8("K", id, *values, 16);
+            };
+        }});
+
+        cases.push_back({"STRING_DYNAMIC", [](const uint32_t values_nb) -> AddRecord {
+            auto values = std::make_shared<std::vector<std::string> >(makeStrings(values_nb));
+            return [values](GBKFCoreWriter &writer, const uint32_t id) {
+                writer.addKeyedValuesStringUTF8("K", id, *values, 0);
+            };
+        }});
+
+        cases.push_back(makeCase<int8_t>("INT8", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesInt8("K", id, v);
+        }));
+        cases.push_back(makeCase<int16_t>("INT16", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesInt16("K", id, v);
+        }));
+        cases.push_back(makeCase<int32_t>("INT32", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesInt32("K", id, v);
+        }));
+        cases.push_back(makeCase<int64_t>("INT64", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesInt64("K", id, v);
+        }));
+        cases.push_back(makeCase<uint8_t>("UINT8", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesUInt8("K", id, v);
+        }));
+        cases.push_back(makeCase<uint16_t>("UINT16", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesUInt16("K", id, v);
+        }));
+        cases.push_back(makeCase<uint32_t>("UINT32", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesUInt32("K", id, v);
+        }));
+        cases.push_back(makeCase<uint64_t>("UINT64", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesUInt64("K", id, v);
+        }));
+        cases.push_back(makeCase<float>("FLOAT32", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesFloat32("K", id, v);
+        }));
+        cases.push_back(makeCase<double>("FLOAT64", [](GBKFCoreWriter &w, uint32_t id, const auto &v) {
+            w.addKeyedValuesFloat64("K", id, v);
+        }));
+
+        return cases;
+    }
+
+    // Best time of the repetitions, in seconds
+    double measure(const unsigned int repetitions, const std::function<void()> &function) {
+        double best_seconds = std::numeric_limits<double>::max();
+
+        for (unsigned int i = 0; i < repetitions; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best_seconds = std::min(best_seconds, elapsed.count());
+        }
+
+        return best_seconds;
+    }
+
+    void printLine(const std::string &operation,
+                   const BenchCase &bench_case,
+                   const RecordsShape &shape,
+                   const bool sha,
+                   const std::string &source,
+                   const uint64_t bytes,
+                   const double seconds) {
+
+        std::printf("%s,%s,%s,%u,%u,%s,%s,%llu,%.6f,%.2f,%.0f\n",
+                    operation.c_str(),
+                    bench_case.type_name.c_str(),
+                    shape.name.c_str(),
+                    shape.records_nb,
+                    shape.values_nb,
+                    sha ? "on" : "off",
+                    source.c_str(),
+                    static_cast<unsigned long long>(bytes),
+                    seconds,
+                    static_cast<double>(bytes) / seconds / 1e6,
+                    static_cast<double>(shape.records_nb) / seconds);
+        std::fflush(stdout);
+    }
+
+    void runCase(const BenchCase &bench_case,
+                 const RecordsShape &shape,
+                 const unsigned int repetitions,
+                 const std::string &file_path) {
+
+        const AddRecord add_record = bench_case.prepare(shape.values_nb);
+
+        const auto fill = [&](GBKFCoreWriter &writer) {
+            writer.setKeyedValuesNb(shape.records_nb);
+            for (uint32_t i = 0; i < shape.records_nb; ++i) {
+                add_record(writer, i);
+            }
+        };
+
+        std::vector<uint8_t> bytes;
+        {
+            GBKFCoreWriter writer;
+            fill(writer);
+            bytes = writer.getBytesBuffer(false);
+        }
+
+        for (const bool sha: {true, false}) {
+
+            // Encoding
+            double seconds = measure(repetitions, [&]() {
+                GBKFCoreWriter writer;
+                fill(writer);
+                g_sink = g_sink + writer.takeBytesBuffer(false, sha).size();
+            });
+            printLine("encode", bench_case, shape, sha, "memory", bytes.size(), seconds);
+
+            seconds = measure(repetitions, [&]() {
+                GBKFCoreWriter writer;
+                fill(writer);
+                writer.write(file_path, false, sha);
+            });
+            printLine("encode", bench_case, shape, sha, "file", bytes.size(), seconds);
+
+            // Decoding, the data always has a footer
+            const auto verification = sha ? GBKFCore::ShaVerification::IMMEDIATE : GBKFCore::ShaVerification::DEFERRED;
+
+            seconds = measure(repetitions, [&]() {
+                const GBKFCoreReader reader(bytes.data(), bytes.size(), verification);
+                g_sink = g_sink + reader.getKeyedEntries().size();
+            });
+            printLine("decode", bench_case, shape, sha, "memory", bytes.size(), seconds);
+
+            GBKFCoreWriter writer;
+            fill(writer);
+            writer.write(file_path, false);
+
+            seconds = measure(repetitions, [&]() {
+                const GBKFCoreReader reader(file_path, verification);
+                g_sink = g_sink + reader.getKeyedEntries().size();
+            });
+            printLine("decode", bench_case, shape, sha, "file", bytes.size(), seconds);
+        }
+    }
+}
+
+int main(const int argc, char **argv) {
+
+    const auto read_argument = [argc, argv](const int argument_nb, const long default_value) {
+        return argc > argument_nb ? std::max(1L, std::strtol(argv[argument_nb], nullptr, 10)) : default_value;
+    };
+
+    const auto scale = static_cast<uint32_t>(read_argument(1, 1));
+    const auto repetitions = static_cast<unsigned int>(read_argument(2, 3));
+
+    // About the same number of values for both shapes
+    const std::vector<RecordsShape> shapes = {
+        {"small", 20000 * scale, 8},
+        {"large", 4 * scale, 40000},
+    };
+
+    const std::string file_path = "bench_core.gbkf";
+
+    std::printf("operation,type,records,records_nb,values_nb,sha,source,bytes,seconds,mb_per_s,records_per_s\n");
+
+    for (const BenchCase &bench_case: makeCases()) {
+        for (const RecordsShape &shape: shapes) {
+            runCase(bench_case, shape, repetitions, file_path);
+        }
+    }
+
+    std::filesystem::remove(file_path);
+
+    return 0;
+}
@@ -17,9 +17,18 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <iterator>
 #include <stdexcept>
+#include <cstring>
+#include <type_traits>
+#include <variant>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
 
 namespace GBKFCore {
 
@@ -47,6 +56,82 @@ namespace GBKFCore {
 
     constexpr uint8_t FOOTER_SIZE = 32;
 
+    // Size of a keyed-values header without the key: instance id (4), value type (1) and values number (4)
+    constexpr uint8_t KEYED_VALUES_HEADER_SIZE = 9;
+
+    // Optional block between the last record and the footer, so the readers that do not know it still read
+    // valid data (it is part of the hash):
+    //      entries: per record, in the records order, key (keys size) | instance id (4) | offset (8) | length (8)
+    //      buckets: buckets number x uint32, the entry number + 1 (0 when empty), at the hash of the key and the
+    //               instance id, with linear probing. The buckets number is a power of 2 above the entries number.
+    //      trailer: index start (8) | entries number (4) | buckets number (4) | version (1) | keyword (8)
+    // The trailer is found at a fixed position, right before the footer.
+    namespace IndexBlock {
+        constexpr const char *KEYWORD = "gbkfindx";
+        constexpr uint8_t KEYWORD_SIZE = 8;
+        constexpr uint8_t VERSION = 1;
+
+        constexpr uint8_t ENTRY_SIZE_WITHOUT_KEY = 4 + 8 + 8;
+        constexpr uint8_t BUCKET_SIZE = 4;
+        constexpr uint8_t TRAILER_SIZE = 8 + 4 + 4 + 1 + KEYWORD_SIZE;
+
+        // FNV-1a of the key and the instance id
+        inline uint64_t hash(const std::string_view key, const uint32_t instance_id) {
+            uint64_t hash = 14695981039346656037ULL;
+            for (const char character: key) {
+                hash = (hash ^ static_cast<uint8_t>(character)) * 1099511628211ULL;
+            }
+            for (int i = 0; i < 4; ++i) {
+                hash = (hash ^ ((instance_id >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        // At most half of the buckets are used
+        inline uint32_t bucketsNb(const uint32_t entries_nb) {
+            if (entries_nb == 0) {
+                return 0;
+            }
+
+            uint64_t buckets_nb = 1;
+            while (buckets_nb < static_cast<uint64_t>(entries_nb) * 2) {
+                buckets_nb <<= 1;
+            }
+            return static_cast<uint32_t>(std::min<uint64_t>(buckets_nb, uint64_t(1) << 31));
+        }
+
+        // Bytes of the block for entries_nb records
+        inline uint64_t size(const uint8_t keys_size, const uint32_t entries_nb) {
+            return entries_nb * static_cast<uint64_t>(keys_size + ENTRY_SIZE_WITHOUT_KEY) +
+                   static_cast<uint64_t>(bucketsNb(entries_nb)) * BUCKET_SIZE + TRAILER_SIZE;
+        }
+    }
+
+    // The codecs are only available when the libraries are built with them, see GBKFCoreCompression.hxx
+    enum class Compression : uint8_t {
+        NONE = 0,
+        ZLIB = 1,
+        LZ4 = 2,
+        ZSTD = 3,
+        DELTA = 4, // Differences of the integer values, zigzag encoded and bit-packed
+    };
+
+    // Optional compression of the values of a record, the value type of the record then has the TYPE_FLAG:
+    //      compression (1) | values size (8) | compressed size (8) | chunk size (4) | chunks number (4) |
+    //      chunks sizes (chunks number x uint32) | chunks
+    // The compressed size counts the bytes after this header. Each chunk holds chunk size bytes of the values
+    // (the last one may be smaller), so the chunks can be decompressed in parallel.
+    namespace CompressedValues {
+        constexpr uint8_t TYPE_FLAG = 0x80;
+        constexpr uint8_t HEADER_SIZE = 1 + 8 + 8 + 4 + 4;
+
+        constexpr uint32_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+        constexpr uint32_t MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+
+        // Smaller values are never compressed
+        constexpr uint64_t MIN_VALUES_SIZE = 64;
+    }
+
     enum class ValueType {
         BLOB = 1,
         BOOLEAN = 2,
@@ -67,83 +152,259 @@ namespace GBKFCore {
         FLOAT64 = 41,
     };
 
-    class KeyedEntry {
+    // Compile-time table of the value types: the C++ type of the values, and the size of each value in the
+    // format (0 for the types of variable size).
+    template<ValueType V>
+    struct ValueTypeTraits;
+
+    template<typename T, size_t Size>
+    struct ValueTypeTraitsBase {
+        using type = T;
+        static constexpr size_t value_size = Size;
+        static constexpr bool fixed_size = Size > 0;
+    };
+
+    template<> struct ValueTypeTraits<ValueType::BLOB> : ValueTypeTraitsBase<uint8_t, 1> {};
+    template<> struct ValueTypeTraits<ValueType::BOOLEAN> : ValueTypeTraitsBase<bool, 0> {};
+    template<> struct ValueTypeTraits<ValueType::STRING> : ValueTypeTraitsBase<std::string, 0> {};
+    template<> struct ValueTypeTraits<ValueType::INT8> : ValueTypeTraitsBase<int8_t, 1> {};
+    template<> struct ValueTypeTraits<ValueType::INT16> : ValueTypeTraitsBase<int16_t, 2> {};
+    template<> struct ValueTypeTraits<ValueType::INT32> : ValueTypeTraitsBase<int32_t, 4> {};
+    template<> struct ValueTypeTraits<ValueType::INT64> : ValueTypeTraitsBase<int64_t, 8> {};
+    template<> struct ValueTypeTraits<ValueType::UINT8> : ValueTypeTraitsBase<uint8_t, 1> {};
+    template<> struct ValueTypeTraits<ValueType::UINT16> : ValueTypeTraitsBase<uint16_t, 2> {};
+    template<> struct ValueTypeTraits<ValueType::UINT32> : ValueTypeTraitsBase<uint32_t, 4> {};
+    template<> struct ValueTypeTraits<ValueType::UINT64> : ValueTypeTraitsBase<uint64_t, 8> {};
+    template<> struct ValueTypeTraits<ValueType::FLOAT32> : ValueTypeTraitsBase<float, 4> {};
+    template<> struct ValueTypeTraits<ValueType::FLOAT64> : ValueTypeTraitsBase<double, 8> {};
+
+    template<ValueType V>
+    using ValueTypeOf = typename ValueTypeTraits<V>::type;
+
+    // Calls function(std::integral_constant<ValueType, V>()) with the runtime type as a compile-time constant V,
+    // so each type has its own specialized path. Throws std::runtime_error if the type is not supported.
+    template<typename Function>
+    decltype(auto) visitValueType(const ValueType type, Function &&function) {
+        switch (type) {
+            case ValueType::BLOB:
+                return function(std::integral_constant<ValueType, ValueType::BLOB>());
+            case ValueType::BOOLEAN:
+                return function(std::integral_constant<ValueType, ValueType::BOOLEAN>());
+            case ValueType::STRING:
+                return function(std::integral_constant<ValueType, ValueType::STRING>());
+            case ValueType::INT8:
+                return function(std::integral_constant<ValueType, ValueType::INT8>());
+            case ValueType::INT16:
+                return function(std::integral_constant<ValueType, ValueType::INT16>());
+            case ValueType::INT32:
+                return function(std::integral_constant<ValueType, ValueType::INT32>());
+            case ValueType::INT64:
+                return function(std::integral_constant<ValueType, ValueType::INT64>());
+            case ValueType::UINT8:
+                return function(std::integral_constant<ValueType, ValueType::UINT8>());
+            case ValueType::UINT16:
+                return function(std::integral_constant<ValueType, ValueType::UINT16>());
+            case ValueType::UINT32:
+                return function(std::integral_constant<ValueType, ValueType::UINT32>());
+            case ValueType::UINT64:
+                return function(std::integral_constant<ValueType, ValueType::UINT64>());
+            case ValueType::FLOAT32:
+                return function(std::integral_constant<ValueType, ValueType::FLOAT32>());
+            case ValueType::FLOAT64:
+                return function(std::integral_constant<ValueType, ValueType::FLOAT64>());
+            default:
+                throw std::runtime_error("Unsupported value type");
+        }
+    }
+
+    // Location of a keyed-values record inside a GBKF buffer, read without decoding its values.
+    struct KeyedRecord {
+        std::string_view key;
+        uint32_t instance_id = 0;
+        ValueType type = ValueType::BLOB;
+        uint32_t values_nb = 0;
+        uint64_t values_pos = 0; // First byte after the record header
+        uint64_t end_pos = 0;    // First byte after the record
+        bool compressed = false; // The values are CompressedValues, of the type above once decompressed
+    };
+
+    // Records of the same key as columns: the values of instance_ids[i] are
+    // values[values_offsets[i]] to values[values_offsets[i + 1]] (excluded).
+    template<typename T>
+    struct KeyedColumns {
+        std::vector<uint32_t> instance_ids;
+        std::vector<T> values;
+        std::vector<uint64_t> values_offsets{0}; // instance_ids.size() + 1 positions
+    };
+
+    // Selection of the records to decode, the records that do not match are skipped without decoding their values.
+    struct KeyedEntriesFilter {
+        // Any key when empty
+        std::vector<std::string> keys;
+
+        // Optional, checked after the keys
+        std::function<bool(std::string_view)> key_predicate;
+
+        // Inclusive range
+        uint32_t instance_id_min = 0;
+        uint32_t instance_id_max = UINT32_MAX;
+
+        // One bit per value type, see typeMask()
+        uint64_t types_mask = ~uint64_t(0);
+
+        static constexpr uint64_t typeMask(const ValueType type) {
+            return uint64_t(1) << static_cast<uint8_t>(type);
+        }
+    };
+
+    // When the reader computes the SHA-256 of the data, to be compared with the footer.
+    enum class ShaVerification {
+        IMMEDIATE = 1,  // On construction
+        DEFERRED = 2,   // On the first call to verifiesSha(), it is never computed if verifiesSha() is not called
+        BACKGROUND = 3, // On a background thread started on construction
+    };
+
+    template<typename T>
+    struct IsString : std::false_type {
+    };
+
+    template<typename Allocator>
+    struct IsString<std::basic_string<char, std::char_traits<char>, Allocator> > : std::true_type {
+    };
+
+    // The vector of the values is stored inline (without a separate allocation for the container), and every
+    // container, including the strings, uses the allocator of the entry. The values themselves are not stored
+    // inline, since getValues() returns a std::vector: a non-empty entry allocates its vector buffer. For many tiny
+    // records, decode into pmr::KeyedEntry with a monotonic resource, so those buffers come from a single arena.
+    // Copies of an entry have their own values, moves do not copy the values.
+    template<typename Allocator>
+    class BasicKeyedEntry {
     public:
+        using allocator_type = Allocator;
+
+        template<typename T>
+        using ValuesAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+        template<typename T>
+        using Vector = std::vector<T, ValuesAllocator<T> >;
+
+        using String = std::basic_string<char, std::char_traits<char>, ValuesAllocator<char> >;
+
+        // BLOB and UINT8 share Vector<uint8_t>.
+        using Values = std::variant<
+            Vector<uint8_t>,
+            Vector<bool>,
+            Vector<String>,
+            Vector<int8_t>,
+            Vector<int16_t>,
+            Vector<int32_t>,
+            Vector<int64_t>,
+            Vector<uint16_t>,
+            Vector<uint32_t>,
+            Vector<uint64_t>,
+            Vector<float>,
+            Vector<double> >;
+
         uint32_t instance_id = 0;
 
-        explicit KeyedEntry(ValueType type);
+        explicit BasicKeyedEntry(ValueType type, const Allocator &allocator = Allocator());
+
+        // Allocator-extended constructors, used by the allocator-aware containers.
+        BasicKeyedEntry(const BasicKeyedEntry &other, const Allocator &allocator);
+
+        BasicKeyedEntry(BasicKeyedEntry &&other, const Allocator &allocator);
 
         template<typename T>
         void addValue(const T &val);
 
-        template<typename T>
-        void addValues(const std::vector<T> &values);
+        template<typename T, typename A = ValuesAllocator<T> >
+        void addValues(const std::vector<T, A> &values);
+
+        // The values are moved, without copy, when the entry is empty and has the same allocator.
+        template<typename T, typename A = ValuesAllocator<T> >
+        void addValues(std::vector<T, A> &&values);
 
         [[nodiscard]] ValueType getType() const;
 
+        [[nodiscard]] Allocator get_allocator() const;
+
         template<typename T>
-        [[nodiscard]] std::vector<T> &getValues();
+        [[nodiscard]] Vector<T> &getValues();
 
-    private:
-        ValueType m_type;
-        std::shared_ptr<void> m_values;
+        template<typename T>
+        [[nodiscard]] const Vector<T> &getValues() const;
 
         template<typename T>
-        static ValueType deduceValueType();
+        [[nodiscard]] static constexpr ValueType deduceValueType();
+
+    private:
+        ValueType m_type;
+        Values m_values;
 
         template<typename T>
         void ensureType() const;
     };
 
-    inline KeyedEntry::KeyedEntry(const ValueType type) : m_type(type) {
+    using KeyedEntry = BasicKeyedEntry<std::allocator<uint8_t> >;
+
+    namespace pmr {
+        // Entry whose values are allocated from a std::pmr::memory_resource, e.g. a monotonic arena.
+        using KeyedEntry = BasicKeyedEntry<std::pmr::polymorphic_allocator<uint8_t> >;
+
+        using KeyedEntriesMap = std::pmr::unordered_map<std::pmr::string, std::pmr::vector<KeyedEntry> >;
+    }
+
+    template<typename Allocator>
+    BasicKeyedEntry<Allocator>::BasicKeyedEntry(const ValueType type, const Allocator &allocator)
+        : m_type(type) {
         switch (type) {
             case ValueType::STRING:
-                m_values = std::make_shared<std::vector<std::string> >();
+                m_values.template emplace<Vector<String> >(allocator);
                 break;
 
             case ValueType::BOOLEAN:
-                m_values = std::make_shared<std::vector<bool> >();
+                m_values.template emplace<Vector<bool> >(allocator);
                 break;
 
             case ValueType::INT8:
-                m_values = std::make_shared<std::vector<int8_t> >();
+                m_values.template emplace<Vector<int8_t> >(allocator);
                 break;
 
             case ValueType::INT16:
-                m_values = std::make_shared<std::vector<int16_t> >();
+                m_values.template emplace<Vector<int16_t> >(allocator);
                 break;
 
             case ValueType::INT32:
-                m_values = std::make_shared<std::vector<int32_t> >();
+                m_values.template emplace<Vector<int32_t> >(allocator);
                 break;
 
             case ValueType::INT64:
-                m_values = std::make_shared<std::vector<int64_t> >();
+                m_values.template emplace<Vector<int64_t> >(allocator);
                 break;
 
             case ValueType::BLOB:
             case ValueType::UINT8:
-                m_values = std::make_shared<std::vector<uint8_t> >();
+                m_values.template emplace<Vector<uint8_t> >(allocator);
                 break;
 
             case ValueType::UINT16:
-                m_values = std::make_shared<std::vector<uint16_t> >();
+                m_values.template emplace<Vector<uint16_t> >(allocator);
                 break;
 
             case ValueType::UINT32:
-                m_values = std::make_shared<std::vector<uint32_t> >();
+                m_values.template emplace<Vector<uint32_t> >(allocator);
                 break;
 
             case ValueType::UINT64:
-                m_values = std::make_shared<std::vector<uint64_t> >();
+                m_values.template emplace<Vector<uint64_t> >(allocator);
                 break;
 
             case ValueType::FLOAT32:
-                m_values = std::make_shared<std::vector<float> >();
+                m_values.template emplace<Vector<float> >(allocator);
                 break;
 
             case ValueType::FLOAT64:
-                m_values = std::make_shared<std::vector<double> >();
+                m_values.template emplace<Vector<double> >(allocator);
                 break;
 
             default:
@@ -151,44 +412,91 @@ namespace GBKFCore {
         }
     }
 
-    template<typename T>
-    void KeyedEntry::addValue(const T &val) {
-        ensureType<T>();
-        getValues<T>()->push_back(val);
+    template<typename Allocator>
+    BasicKeyedEntry<Allocator>::BasicKeyedEntry(const BasicKeyedEntry &other, const Allocator &allocator)
+        : instance_id(other.instance_id), m_type(other.m_type) {
+        std::visit([this, &allocator](const auto &values) {
+            using VectorType = std::decay_t<decltype(values)>;
+            m_values.template emplace<VectorType>(values, allocator);
+        }, other.m_values);
+    }
+
+    template<typename Allocator>
+    BasicKeyedEntry<Allocator>::BasicKeyedEntry(BasicKeyedEntry &&other, const Allocator &allocator)
+        : instance_id(other.instance_id), m_type(other.m_type) {
+        std::visit([this, &allocator](auto &values) {
+            using VectorType = std::decay_t<decltype(values)>;
+            m_values.template emplace<VectorType>(std::move(values), allocator);
+        }, other.m_values);
     }
 
+    template<typename Allocator>
     template<typename T>
-    void KeyedEntry::addValues(const std::vector<T> &values) {
-        ensureType<T>();
+    void BasicKeyedEntry<Allocator>::addValue(const T &val) {
+        getValues<T>().push_back(val);
+    }
+
+    template<typename Allocator>
+    template<typename T, typename A>
+    void BasicKeyedEntry<Allocator>::addValues(const std::vector<T, A> &values) {
         auto &vec = getValues<T>();
         vec.insert(vec.end(), values.begin(), values.end());
     }
 
-    inline ValueType KeyedEntry::getType() const {
+    template<typename Allocator>
+    template<typename T, typename A>
+    void BasicKeyedEntry<Allocator>::addValues(std::vector<T, A> &&values) {
+        auto &vec = getValues<T>();
+        if constexpr (std::is_same_v<A, ValuesAllocator<T> >) {
+            if (vec.empty() && vec.get_allocator() == values.get_allocator()) {
+                vec = std::move(values);
+                return;
+            }
+        }
+        vec.insert(vec.end(), std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+    }
+
+    template<typename Allocator>
+    ValueType BasicKeyedEntry<Allocator>::getType() const {
         return m_type;
     }
 
+    template<typename Allocator>
+    Allocator BasicKeyedEntry<Allocator>::get_allocator() const {
+        return std::visit([](const auto &values) { return Allocator(values.get_allocator()); }, m_values);
+    }
+
+    template<typename Allocator>
+    template<typename T>
+    typename BasicKeyedEntry<Allocator>::template Vector<T> &BasicKeyedEntry<Allocator>::getValues() {
+        ensureType<T>();
+        return *std::get_if<Vector<T> >(&m_values);
+    }
+
+    template<typename Allocator>
     template<typename T>
-    std::vector<T> &KeyedEntry::getValues() {
+    const typename BasicKeyedEntry<Allocator>::template Vector<T> &BasicKeyedEntry<Allocator>::getValues() const {
         ensureType<T>();
-        return *static_cast<std::vector<T> *>(m_values.get());
+        return *std::get_if<Vector<T> >(&m_values);
     }
 
+    template<typename Allocator>
     template<typename T>
-    void KeyedEntry::ensureType() const {
+    void BasicKeyedEntry<Allocator>::ensureType() const {
         if (const ValueType deduced_type = deduceValueType<T>();
             m_type != deduced_type &&
-            (m_type != ValueType::BLOB && deduced_type != ValueType::UINT8)) {
+            !(m_type == ValueType::BLOB && deduced_type == ValueType::UINT8)) {
             throw std::runtime_error("Type mismatch on KeyedEntry access");
         }
     }
 
 
+    template<typename Allocator>
     template<typename T>
-    ValueType KeyedEntry::deduceValueType() {
+    constexpr ValueType BasicKeyedEntry<Allocator>::deduceValueType() {
         if constexpr (std::is_same_v<T, bool>) {
             return ValueType::BOOLEAN;
-        } else if constexpr (std::is_same_v<T, std::string>) {
+        } else if constexpr (IsString<T>::value) {
             return ValueType::STRING;
         } else if constexpr (std::is_same_v<T, int8_t>) {
             return ValueType::INT8;
@@ -215,6 +523,97 @@ namespace GBKFCore {
             throw std::invalid_argument("Unsupported type");
         }
     }
+
+    // Read-only view over fixed-width values stored in a GBKF buffer, without copy.
+    //
+    // The values are not aligned in the format, so they are read with memcpy (which compiles into plain loads).
+    // alignedData() gives direct access to the values, but only if they happen to be aligned.
+    // The view remains valid while the buffer it points to is alive (e.g. the reader that returned it).
+    template<typename T>
+    class ValuesView {
+    public:
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Only fixed-width values have views");
+
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T *;
+            using reference = T;
+
+            explicit Iterator(const uint8_t *ptr) : m_ptr(ptr) {}
+
+            T operator*() const {
+                T value;
+                std::memcpy(&value, m_ptr, sizeof(T));
+                return value;
+            }
+
+            Iterator &operator++() {
+                m_ptr += sizeof(T);
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                m_ptr += sizeof(T);
+                return previous;
+            }
+
+            bool operator==(const Iterator &other) const { return m_ptr == other.m_ptr; }
+
+            bool operator!=(const Iterator &other) const { return m_ptr != other.m_ptr; }
+
+        private:
+            const uint8_t *m_ptr;
+        };
+
+        ValuesView() = default;
+
+        ValuesView(const uint8_t *bytes, const uint32_t size) : m_bytes(bytes), m_size(size) {}
+
+        [[nodiscard]] uint32_t size() const { return m_size; }
+
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+
+        [[nodiscard]] T operator[](const uint32_t index) const {
+            T value;
+            std::memcpy(&value, m_bytes + static_cast<uint64_t>(index) * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        [[nodiscard]] Iterator begin() const { return Iterator(m_bytes); }
+
+        [[nodiscard]] Iterator end() const { return Iterator(m_bytes + static_cast<uint64_t>(m_size) * sizeof(T)); }
+
+        // Raw little-endian bytes of the values
+        [[nodiscard]] const uint8_t *bytes() const { return m_bytes; }
+
+        [[nodiscard]] bool isAligned() const {
+            return reinterpret_cast<std::uintptr_t>(m_bytes) % alignof(T) == 0;
+        }
+
+        // Throws std::runtime_error if the values are not aligned for T.
+        [[nodiscard]] const T *alignedData() const {
+            if (!isAligned()) {
+                throw std::runtime_error("Values not aligned");
+            }
+            return reinterpret_cast<const T *>(m_bytes);
+        }
+
+        [[nodiscard]] std::vector<T> toVector() const {
+            std::vector<T> values(m_size);
+            if (m_size > 0) {
+                std::memcpy(values.data(), m_bytes, static_cast<uint64_t>(m_size) * sizeof(T));
+            }
+            return values;
+        }
+
+    private:
+        const uint8_t *m_bytes = nullptr;
+        uint32_t m_size = 0;
+    };
 };
 
 #endif // GBKF_CORE_HXX
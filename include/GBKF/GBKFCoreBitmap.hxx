@@ -0,0 +1,166 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_BITMAP_HXX
+#define GBKF_CORE_BITMAP_HXX
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+// SSE2 is part of x86-64, so it needs no runtime detection
+#if !defined(GBKF_NO_BITMAP_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+    #define GBKF_BITMAP_SIMD_X86
+    #include <emmintrin.h>
+#endif
+
+// The booleans of the format are packed LSB-first: the value i is the bit i % 8 of the byte i / 8.
+// Define GBKF_NO_BITMAP_SIMD to always use the portable loops.
+namespace GBKFCore::Bitmap {
+
+    inline uint64_t bytesNb(const uint64_t bits_nb) {
+        return (bits_nb + 7) / 8;
+    }
+
+    // Writes bytesNb(values_nb) bytes, the bits after the last value are 0.
+    inline void pack(const bool *values, const uint64_t values_nb, uint8_t *packed) {
+        const auto *bytes = reinterpret_cast<const uint8_t *>(values);
+        uint64_t i = 0;
+
+#if defined(GBKF_BITMAP_SIMD_X86)
+        // 16 values at a time: the mask of the non-zero bytes is the packed bits
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= values_nb; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+            const auto bits = static_cast<uint16_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+            std::memcpy(packed + i / 8, &bits, 2);
+        }
+#endif
+
+        // 8 values at a time
+        for (; i + 8 <= values_nb; i += 8) {
+            uint8_t byte = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                byte |= static_cast<uint8_t>((bytes[i + bit] != 0) << bit);
+            }
+            packed[i / 8] = byte;
+        }
+
+        if (i < values_nb) {
+            uint8_t byte = 0;
+            for (uint8_t bit = 0; i + bit < values_nb; ++bit) {
+                byte |= static_cast<uint8_t>((bytes[i + bit] != 0) << bit);
+            }
+            packed[i / 8] = byte;
+        }
+    }
+
+    // Writes values_nb booleans.
+    inline void unpack(const uint8_t *packed, const uint64_t values_nb, bool *values) {
+        uint64_t i = 0;
+
+#if defined(GBKF_BITMAP_SIMD_X86)
+        // 16 values at a time: each of the 2 bytes is repeated 8 times, and compared to its bits
+        const __m128i bit_masks = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+        const __m128i ones = _mm_set1_epi8(1);
+        for (; i + 16 <= values_nb; i += 16) {
+            uint16_t bits;
+            std::memcpy(&bits, packed + i / 8, 2);
+
+            __m128i repeated = _mm_cvtsi32_si128(bits);
+            repeated = _mm_unpacklo_epi8(repeated, repeated);
+            repeated = _mm_unpacklo_epi16(repeated, repeated);
+            repeated = _mm_unpacklo_epi32(repeated, repeated);
+
+            const __m128i selected = _mm_cmpeq_epi8(_mm_and_si128(repeated, bit_masks), bit_masks);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(values + i), _mm_and_si128(selected, ones));
+        }
+#endif
+
+        for (; i < values_nb; ++i) {
+            values[i] = (packed[i / 8] >> (i % 8)) & 1;
+        }
+    }
+
+    // Number of bits set among the first bits_nb bits.
+    inline uint64_t count(const uint8_t *packed, const uint64_t bits_nb) {
+        uint64_t bits_set = 0;
+        uint64_t i = 0;
+
+        for (; i + 64 <= bits_nb; i += 64) {
+            uint64_t word;
+            std::memcpy(&word, packed + i / 8, 8);
+#if defined(__GNUC__)
+            bits_set += static_cast<uint64_t>(__builtin_popcountll(word));
+#else
+            for (; word != 0; word &= word - 1) {
+                ++bits_set;
+            }
+#endif
+        }
+
+        for (; i < bits_nb; ++i) {
+            bits_set += (packed[i / 8] >> (i % 8)) & 1;
+        }
+
+        return bits_set;
+    }
+}
+
+namespace GBKFCore {
+
+    // Read-only view over packed booleans stored in a GBKF buffer, without copy.
+    // The view remains valid while the buffer it points to is alive (e.g. the reader that returned it).
+    class BitmapView {
+    public:
+        BitmapView() = default;
+
+        BitmapView(const uint8_t *bytes, const uint32_t size) : m_bytes(bytes), m_size(size) {}
+
+        // Number of booleans
+        [[nodiscard]] uint32_t size() const { return m_size; }
+
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+
+        [[nodiscard]] bool operator[](const uint32_t index) const {
+            return (m_bytes[index / 8] >> (index % 8)) & 1;
+        }
+
+        // Packed LSB-first bytes, the bits after the last boolean are not specified
+        [[nodiscard]] const uint8_t *bytes() const { return m_bytes; }
+
+        [[nodiscard]] uint64_t bytesNb() const { return Bitmap::bytesNb(m_size); }
+
+        // Number of true values
+        [[nodiscard]] uint64_t count() const { return Bitmap::count(m_bytes, m_size); }
+
+        // Writes size() booleans.
+        void unpack(bool *values) const { Bitmap::unpack(m_bytes, m_size, values); }
+
+        [[nodiscard]] std::vector<bool> toVector() const {
+            std::vector<bool> values(m_size);
+            for (uint32_t i = 0; i < m_size; ++i) {
+                values[i] = (*this)[i];
+            }
+            return values;
+        }
+
+    private:
+        const uint8_t *m_bytes = nullptr;
+        uint32_t m_size = 0;
+    };
+}
+
+#endif // GBKF_CORE_BITMAP_HXX
@@ -0,0 +1,185 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_COMPRESSION_HXX
+#define GBKF_CORE_COMPRESSION_HXX
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#ifdef GBKF_USE_ZLIB
+    #include <zlib.h>
+#endif
+
+#ifdef GBKF_USE_LZ4
+    #include <lz4.h>
+#endif
+
+#ifdef GBKF_USE_ZSTD
+    #include <zstd.h>
+#endif
+
+#include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreDelta.hxx"
+
+// Codecs of the compressed records (see GBKFCore::CompressedValues). Compression::DELTA is always available
+// (see GBKFCoreDelta.hxx), the others only when the libraries are built with their CMake option:
+// GBKF_USE_ZLIB, GBKF_USE_LZ4 or GBKF_USE_ZSTD.
+//
+// The value size is the size of each value of the record, Compression::DELTA only encodes integer values.
+namespace GBKFCore::Codecs {
+
+    inline bool isAvailable(const Compression compression) {
+        switch (compression) {
+            case Compression::DELTA:
+                return true;
+#ifdef GBKF_USE_ZLIB
+            case Compression::ZLIB:
+                return true;
+#endif
+#ifdef GBKF_USE_LZ4
+            case Compression::LZ4:
+                return true;
+#endif
+#ifdef GBKF_USE_ZSTD
+            case Compression::ZSTD:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    // Maximum size of the compressed data. The chunks are at most CompressedValues::MAX_CHUNK_SIZE bytes.
+    inline uint64_t compressBound(const Compression compression, const uint32_t size, const uint8_t value_size) {
+        switch (compression) {
+            case Compression::DELTA:
+                return Delta::compressBound(size, value_size);
+#ifdef GBKF_USE_ZLIB
+            case Compression::ZLIB:
+                return ::compressBound(size);
+#endif
+#ifdef GBKF_USE_LZ4
+            case Compression::LZ4:
+                return static_cast<uint64_t>(LZ4_compressBound(static_cast<int>(size)));
+#endif
+#ifdef GBKF_USE_ZSTD
+            case Compression::ZSTD:
+                return ZSTD_compressBound(size);
+#endif
+            default:
+                throw std::invalid_argument("Compression not available in this build");
+        }
+    }
+
+    // Returns the size of the compressed data, the level 0 is the default level of the codec
+    // (ignored by LZ4 and DELTA).
+    inline uint64_t compress(const Compression compression,
+                             const uint8_t *source,
+                             const uint32_t size,
+                             uint8_t *destination,
+                             const uint64_t capacity,
+                             [[maybe_unused]] const int level,
+                             const uint8_t value_size) {
+        switch (compression) {
+            case Compression::DELTA:
+                return Delta::encode(source, size, value_size, destination, capacity);
+#ifdef GBKF_USE_ZLIB
+            case Compression::ZLIB: {
+                uLongf compressed_size = static_cast<uLongf>(capacity);
+                if (compress2(destination, &compressed_size, source, size,
+                              level == 0 ? Z_DEFAULT_COMPRESSION : level) != Z_OK) {
+                    throw std::runtime_error("Compression failed");
+                }
+                return compressed_size;
+            }
+#endif
+#ifdef GBKF_USE_LZ4
+            case Compression::LZ4: {
+                const int compressed_size = LZ4_compress_default(
+                    reinterpret_cast<const char *>(source),
+                    reinterpret_cast<char *>(destination),
+                    static_cast<int>(size),
+                    static_cast<int>(std::min<uint64_t>(capacity, std::numeric_limits<int>::max())));
+                if (compressed_size <= 0) {
+                    throw std::runtime_error("Compression failed");
+                }
+                return static_cast<uint64_t>(compressed_size);
+            }
+#endif
+#ifdef GBKF_USE_ZSTD
+            case Compression::ZSTD: {
+                const size_t compressed_size = ZSTD_compress(destination, capacity, source, size, level);
+                if (ZSTD_isError(compressed_size)) {
+                    throw std::runtime_error("Compression failed");
+                }
+                return compressed_size;
+            }
+#endif
+            default:
+                throw std::invalid_argument("Compression not available in this build");
+        }
+    }
+
+    // The destination must have exactly the size of the data before its compression.
+    inline void decompress(const Compression compression,
+                           const uint8_t *source,
+                           const uint32_t size,
+                           uint8_t *destination,
+                           const uint32_t decompressed_size,
+                           const uint8_t value_size) {
+        bool decompressed = false;
+
+        switch (compression) {
+            case Compression::DELTA:
+                Delta::decode(source, size, value_size, destination, decompressed_size);
+                decompressed = true;
+                break;
+#ifdef GBKF_USE_ZLIB
+            case Compression::ZLIB: {
+                uLongf destination_size = decompressed_size;
+                decompressed = uncompress(destination, &destination_size, source, size) == Z_OK &&
+                               destination_size == decompressed_size;
+                break;
+            }
+#endif
+#ifdef GBKF_USE_LZ4
+            case Compression::LZ4:
+                decompressed = size <= static_cast<uint32_t>(std::numeric_limits<int>::max()) &&
+                               decompressed_size <= static_cast<uint32_t>(std::numeric_limits<int>::max()) &&
+                               LZ4_decompress_safe(reinterpret_cast<const char *>(source),
+                                                   reinterpret_cast<char *>(destination),
+                                                   static_cast<int>(size),
+                                                   static_cast<int>(decompressed_size)) ==
+                               static_cast<int>(decompressed_size);
+                break;
+#endif
+#ifdef GBKF_USE_ZSTD
+            case Compression::ZSTD:
+                decompressed = ZSTD_decompress(destination, decompressed_size, source, size) == decompressed_size;
+                break;
+#endif
+            default:
+                throw std::runtime_error("Compression not available in this build");
+        }
+
+        if (!decompressed) {
+            throw std::runtime_error("Corrupted compressed values");
+        }
+    }
+}
+
+#endif // GBKF_CORE_COMPRESSION_HXX
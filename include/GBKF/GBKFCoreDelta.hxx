@@ -0,0 +1,303 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_DELTA_HXX
+#define GBKF_CORE_DELTA_HXX
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if !defined(GBKF_NO_DELTA_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+    #define GBKF_DELTA_SIMD_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+
+#include "GBKF/GBKFCore.hxx"
+
+// Compression::DELTA, for the integer values: each chunk stores its first value, then the differences between
+// consecutive values, zigzag encoded and bit-packed LSB-first with the bit width of the largest one:
+//      first value (8) | bit width (1) | packed differences | padding (8)
+// The differences wrap around the size of the values, so any sequence is encoded, and sorted sequences
+// (timestamps, counters, ids) only take a few bits per value. Widths above MAX_PACKED_BITS are stored as 64 bits.
+//
+// The decoding runs 8 values at a time with AVX2 when the CPU supports it (detected at runtime), and can be
+// disabled by defining GBKF_NO_DELTA_SIMD.
+namespace GBKFCore::Delta {
+
+    constexpr uint8_t CHUNK_HEADER_SIZE = 8 + 1;
+    constexpr uint8_t PADDING_SIZE = 8;
+
+    // A packed value is read with a 64-bit load, from the byte of its first bit
+    constexpr uint8_t MAX_PACKED_BITS = 64 - 7;
+
+    // Size of the values that can be encoded, 0 for the other types
+    inline uint8_t integerValueSize(const ValueType type) {
+        switch (type) {
+            case ValueType::INT8:
+            case ValueType::UINT8:
+                return 1;
+            case ValueType::INT16:
+            case ValueType::UINT16:
+                return 2;
+            case ValueType::INT32:
+            case ValueType::UINT32:
+                return 4;
+            case ValueType::INT64:
+            case ValueType::UINT64:
+                return 8;
+            default:
+                return 0;
+        }
+    }
+
+    inline uint64_t compressBound(const uint64_t size, const uint8_t value_size) {
+        return CHUNK_HEADER_SIZE + (size / value_size) * 8 + PADDING_SIZE;
+    }
+
+    inline uint64_t load64(const uint8_t *data) {
+        uint64_t value;
+        std::memcpy(&value, data, 8);
+        return value;
+    }
+
+    // The value, with the sign of the values of value_size bytes, as a 64-bit integer
+    inline int64_t signExtend(const uint64_t value, const uint8_t value_size) {
+        const unsigned int shift = 64 - value_size * 8;
+        return static_cast<int64_t>(value << shift) >> shift;
+    }
+
+    // Returns the size of the encoded chunk
+    inline uint64_t encode(const uint8_t *source,
+                           const uint64_t size,
+                           const uint8_t value_size,
+                           uint8_t *destination,
+                           const uint64_t capacity) {
+        if (value_size == 0 || size % value_size != 0 || size == 0) {
+            throw std::invalid_argument("Delta compression of invalid values");
+        }
+
+        const uint64_t values_nb = size / value_size;
+
+        std::vector<uint64_t> zigzags(values_nb - 1);
+        uint64_t previous = 0;
+        std::memcpy(&previous, source, value_size);
+
+        uint64_t zigzags_or = 0;
+        for (uint64_t i = 1; i < values_nb; ++i) {
+            uint64_t current = 0;
+            std::memcpy(&current, source + i * value_size, value_size);
+
+            const int64_t delta = signExtend(current - previous, value_size);
+            zigzags[i - 1] = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+            zigzags_or |= zigzags[i - 1];
+            previous = current;
+        }
+
+        uint8_t bits_nb = 0;
+        while (bits_nb < 64 && (zigzags_or >> bits_nb) != 0) {
+            ++bits_nb;
+        }
+        if (bits_nb > MAX_PACKED_BITS) {
+            bits_nb = 64;
+        }
+
+        const uint64_t packed_size = ((values_nb - 1) * bits_nb + 7) / 8;
+        const uint64_t encoded_size = CHUNK_HEADER_SIZE + packed_size + PADDING_SIZE;
+        if (encoded_size > capacity) {
+            throw std::runtime_error("Compression failed");
+        }
+
+        std::memset(destination, 0, encoded_size);
+        std::memcpy(destination, source, value_size);
+        destination[8] = bits_nb;
+
+        uint8_t *packed = destination + CHUNK_HEADER_SIZE;
+        if (bits_nb == 64) {
+            std::memcpy(packed, zigzags.data(), zigzags.size() * 8);
+        } else if (bits_nb > 0) {
+            for (uint64_t i = 0; i < zigzags.size(); ++i) {
+                const uint64_t bit_pos = i * bits_nb;
+                const uint64_t word = load64(packed + bit_pos / 8) | (zigzags[i] << (bit_pos % 8));
+                std::memcpy(packed + bit_pos / 8, &word, 8);
+            }
+        }
+
+        return encoded_size;
+    }
+
+    inline void storeValue(uint8_t *destination, const uint64_t value, const uint8_t value_size) {
+        std::memcpy(destination, &value, value_size);
+    }
+
+    inline uint64_t unpackZigzag(const uint8_t *packed, const uint64_t i, const uint8_t bits_nb, const uint64_t mask) {
+        const uint64_t bit_pos = i * bits_nb;
+        return (load64(packed + bit_pos / 8) >> (bit_pos % 8)) & mask;
+    }
+
+    inline uint64_t unzigzag(const uint64_t zigzag) {
+        return (zigzag >> 1) ^ (0 - (zigzag & 1));
+    }
+
+    // Decodes the differences from the value i, and returns the last value
+    inline uint64_t decodePortable(const uint8_t *packed,
+                                   uint64_t i,
+                                   const uint64_t values_nb,
+                                   const uint8_t bits_nb,
+                                   uint64_t previous,
+                                   uint8_t *destination,
+                                   const uint8_t value_size) {
+        const uint64_t mask = bits_nb >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits_nb) - 1;
+
+        for (; i < values_nb; ++i) {
+            const uint64_t zigzag = bits_nb == 64 ? load64(packed + (i - 1) * 8)
+                                                  : unpackZigzag(packed, i - 1, bits_nb, mask);
+            previous += unzigzag(zigzag);
+            storeValue(destination + i * value_size, previous, value_size);
+        }
+
+        return previous;
+    }
+
+#if defined(GBKF_DELTA_SIMD_X86)
+
+    // AVX2 also needs the OS to save the YMM registers: OSXSAVE, then the XMM and YMM bits of XCR0
+    inline bool detectSimdSupport() {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+            return false;
+        }
+
+        unsigned int xcr0_low, xcr0_high;
+        __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+        if ((xcr0_low & 0x6) != 0x6) {
+            return false;
+        }
+
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_AVX2);
+    }
+
+    // Differences of the 4 lanes at the bit positions, summed: [a, b, c, d] -> [a, a+b, a+b+c, a+b+c+d]
+    __attribute__((target("avx2")))
+    inline __m256i unpackPrefixSum(const uint8_t *packed, const __m256i bits_pos, const __m256i mask) {
+        const __m256i words = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(packed),
+                                                      _mm256_srli_epi64(bits_pos, 3),
+                                                      1);
+        const __m256i zigzags = _mm256_and_si256(
+            _mm256_srlv_epi64(words, _mm256_and_si256(bits_pos, _mm256_set1_epi64x(7))), mask);
+
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i deltas = _mm256_xor_si256(_mm256_srli_epi64(zigzags, 1),
+                                          _mm256_sub_epi64(zero, _mm256_and_si256(zigzags, _mm256_set1_epi64x(1))));
+
+        deltas = _mm256_add_epi64(deltas, _mm256_blend_epi32(_mm256_permute4x64_epi64(deltas, 0x90), zero, 0x03));
+        return _mm256_add_epi64(deltas, _mm256_blend_epi32(_mm256_permute4x64_epi64(deltas, 0x40), zero, 0x0F));
+    }
+
+    __attribute__((target("avx2")))
+    inline void storeValues(uint8_t *destination, const __m256i values, const uint8_t value_size) {
+        if (value_size == 8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination), values);
+            return;
+        }
+
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), values);
+        for (int lane = 0; lane < 4; ++lane) {
+            storeValue(destination + lane * value_size, lanes[lane], value_size);
+        }
+    }
+
+    // 8 values at a time, in 2 groups of 4 lanes: the packed words are gathered from the byte of their first bit,
+    // shifted, zigzag decoded and summed in the registers, so only one sum per 8 values depends on the previous ones.
+    __attribute__((target("avx2")))
+    inline uint64_t decodeSimd(const uint8_t *packed,
+                               const uint64_t values_nb,
+                               const uint8_t bits_nb,
+                               const uint64_t first,
+                               uint8_t *destination,
+                               const uint8_t value_size) {
+        const __m256i mask = _mm256_set1_epi64x(static_cast<long long>((uint64_t(1) << bits_nb) - 1));
+        const __m256i group_bits = _mm256_set1_epi64x(4 * static_cast<long long>(bits_nb));
+        const __m256i step_bits = _mm256_set1_epi64x(8 * static_cast<long long>(bits_nb));
+
+        __m256i bits_pos = _mm256_set_epi64x(3 * bits_nb, 2 * bits_nb, bits_nb, 0);
+        __m256i carry = _mm256_set1_epi64x(static_cast<long long>(first));
+
+        uint64_t i = 1;
+        for (; i + 8 <= values_nb; i += 8) {
+            const __m256i low_sums = unpackPrefixSum(packed, bits_pos, mask);
+            __m256i high_sums = unpackPrefixSum(packed, _mm256_add_epi64(bits_pos, group_bits), mask);
+            high_sums = _mm256_add_epi64(high_sums, _mm256_permute4x64_epi64(low_sums, 0xFF));
+            bits_pos = _mm256_add_epi64(bits_pos, step_bits);
+
+            const __m256i high_values = _mm256_add_epi64(high_sums, carry);
+            storeValues(destination + i * value_size, _mm256_add_epi64(low_sums, carry), value_size);
+            storeValues(destination + (i + 4) * value_size, high_values, value_size);
+            carry = _mm256_permute4x64_epi64(high_values, 0xFF);
+        }
+
+        const auto previous = static_cast<uint64_t>(_mm256_extract_epi64(carry, 0));
+        return decodePortable(packed, i, values_nb, bits_nb, previous, destination, value_size);
+    }
+
+#endif
+
+    // True when the decoding uses the SIMD instructions, detected once.
+    inline bool isSimdSupported() {
+#if defined(GBKF_DELTA_SIMD_X86)
+        static const bool supported = detectSimdSupport();
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    // The destination must have exactly the size of the values before their encoding.
+    inline void decode(const uint8_t *source,
+                       const uint64_t size,
+                       const uint8_t value_size,
+                       uint8_t *destination,
+                       const uint64_t decoded_size) {
+        if (value_size == 0 || decoded_size % value_size != 0 || decoded_size == 0 || size < CHUNK_HEADER_SIZE) {
+            throw std::runtime_error("Corrupted compressed values");
+        }
+
+        const uint64_t values_nb = decoded_size / value_size;
+        const uint8_t bits_nb = source[8];
+
+        if ((bits_nb > MAX_PACKED_BITS && bits_nb != 64) ||
+            size != CHUNK_HEADER_SIZE + ((values_nb - 1) * bits_nb + 7) / 8 + PADDING_SIZE) {
+            throw std::runtime_error("Corrupted compressed values");
+        }
+
+        const uint64_t first = load64(source);
+        storeValue(destination, first, value_size);
+
+        const uint8_t *packed = source + CHUNK_HEADER_SIZE;
+
+#if defined(GBKF_DELTA_SIMD_X86)
+        if (bits_nb > 0 && bits_nb <= MAX_PACKED_BITS && isSimdSupported()) {
+            (void) decodeSimd(packed, values_nb, bits_nb, first, destination, value_size);
+            return;
+        }
+#endif
+
+        (void) decodePortable(packed, 1, values_nb, bits_nb, first, destination, value_size);
+    }
+}
+
+#endif // GBKF_CORE_DELTA_HXX
@@ -17,17 +17,53 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <unordered_map>
 #include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreStats.hxx"
+#include "GBKF/GBKFCoreBitmap.hxx"
 
 class GBKFCoreReader {
 public:
-    explicit GBKFCoreReader(const std::string &read_path);
+    // The file is memory-mapped when the platform supports it, otherwise it is loaded into RAM.
+    explicit GBKFCoreReader(const std::string &read_path,
+                            GBKFCore::ShaVerification sha_verification = GBKFCore::ShaVerification::IMMEDIATE);
+
+    // The data is copied into the reader.
+    explicit GBKFCoreReader(const std::vector<uint8_t> &data,
+                            GBKFCore::ShaVerification sha_verification = GBKFCore::ShaVerification::IMMEDIATE);
+
+    // The data is moved into the reader, without copy.
+    explicit GBKFCoreReader(std::vector<uint8_t> &&data,
+                            GBKFCore::ShaVerification sha_verification = GBKFCore::ShaVerification::IMMEDIATE);
+
+    // Non-owning view: the data must outlive the reader and any of its copies.
+    GBKFCoreReader(const uint8_t *data,
+                   uint64_t size,
+                   GBKFCore::ShaVerification sha_verification = GBKFCore::ShaVerification::IMMEDIATE);
+
+    // Opens the files on threads_nb background threads (std::thread::hardware_concurrency() if 0), so the I/O,
+    // the header parsing and the SHA-256 of different files overlap. Returns right away: each future becomes ready
+    // with the reader or the exception of its file as soon as it is open, in the order of the paths. The remaining
+    // files are still opened if the futures are dropped, wait for them before the end of the program.
+    [[nodiscard]] static std::vector<std::shared_future<GBKFCoreReader> > openMany(
+        const std::vector<std::string> &paths,
+        GBKFCore::ShaVerification sha_verification = GBKFCore::ShaVerification::IMMEDIATE,
+        unsigned int threads_nb = 0);
+
+    // With ShaVerification::DEFERRED, the hash is computed on the first call.
+    // With ShaVerification::BACKGROUND, the call waits for the hashing thread if it has not finished.
+    [[nodiscard]] bool verifiesSha() const;
 
-    explicit GBKFCoreReader(const std::vector<uint8_t> &data);
+    // Counters of this reader, shared with its copies. They stay at 0 unless the library is built with GBKF_STATS.
+    [[nodiscard]] GBKFCore::Stats getStats() const;
 
-    [[nodiscard]] bool verifiesSha() const;
+    void resetStats();
 
     [[nodiscard]] uint8_t getGBKFVersion() const;
 
@@ -39,12 +75,86 @@ public:
 
     [[nodiscard]] uint32_t getKeyedValuesNb() const;
 
+    // True when the data has a valid index block (see GBKFCoreWriter::setIndexBlock). Then getKeyedEntry(),
+    // hasKeyedEntry(), getValuesView(), getStringViews() and readValues() find a record without scanning the others,
+    // until the records are scanned by another method.
+    [[nodiscard]] bool hasIndexBlock() const;
+
     [[nodiscard]] std::unordered_map<std::string, std::vector<GBKFCore::KeyedEntry> > getKeyedEntries() const;
 
+    // Decodes the records on several threads, in ranges of about the same size in bytes.
+    // With 0 threads, std::thread::hardware_concurrency() is used. The result is the same as getKeyedEntries().
+    [[nodiscard]] std::unordered_map<std::string, std::vector<GBKFCore::KeyedEntry> > getKeyedEntries(
+        unsigned int threads_nb) const;
+
+    // Every allocation of the result (keys, entries, values and strings) is made from the memory resource,
+    // so a std::pmr::monotonic_buffer_resource can release it at once. The resource must outlive the result.
+    [[nodiscard]] GBKFCore::pmr::KeyedEntriesMap getKeyedEntries(std::pmr::memory_resource *resource) const;
+
+    // Decodes only the records matching the filter. The cached records are used if they were already scanned,
+    // otherwise the records are scanned without caching them. The entries keep the order of the file.
+    [[nodiscard]] std::unordered_map<std::string, std::vector<GBKFCore::KeyedEntry> > getKeyedEntries(
+        const GBKFCore::KeyedEntriesFilter &filter) const;
+
+    // The records are scanned once, on the first call of any of these methods, and then cached.
+    // The keys of the records are views into the reader data.
+    [[nodiscard]] const std::vector<GBKFCore::KeyedRecord> &getKeyedRecords() const;
+
+    [[nodiscard]] std::vector<GBKFCore::KeyedEntry> findEntries(const std::string &key) const;
+
+    [[nodiscard]] bool hasKeyedEntry(const std::string &key, uint32_t instance_id) const;
+
+    // Throws std::out_of_range if there is no entry matching the key and instance id.
+    [[nodiscard]] GBKFCore::KeyedEntry getKeyedEntry(const std::string &key, uint32_t instance_id) const;
+
+    // Decodes the values of a record whose type is known at compile time, without the type dispatch of
+    // getKeyedEntry(). Throws std::out_of_range if there is no entry, and std::runtime_error if the type differs.
+    template<GBKFCore::ValueType V>
+    [[nodiscard]] std::vector<GBKFCore::ValueTypeOf<V> > readValues(const std::string &key, uint32_t instance_id) const;
+
+    // View into the reader data, without copy. See GBKFCore::ValuesView for the alignment rules.
+    // Throws std::out_of_range if there is no entry, and std::runtime_error if the type does not match
+    // or if the values are compressed.
+    template<typename T>
+    [[nodiscard]] GBKFCore::ValuesView<T> getValuesView(const std::string &key, uint32_t instance_id) const;
+
+    // Every record of the key, in the order of the file, decoded with a single allocation per column.
+    // T is any fixed-width type. Throws std::runtime_error if a record of the key has another type.
+    template<typename T>
+    [[nodiscard]] GBKFCore::KeyedColumns<T> getKeyedColumns(const std::string &key) const;
+
+    // View of the packed BOOLEAN values, without copy, valid while the reader (or a copy of it) is alive.
+    // Throws std::out_of_range if there is no entry, and std::runtime_error if the values are not booleans
+    // or if they are compressed.
+    [[nodiscard]] GBKFCore::BitmapView getBitmapView(const std::string &key, uint32_t instance_id) const;
+
+    // Views into the reader data, without copy, valid while the reader (or a copy of it) is alive.
+    // Throws std::out_of_range if there is no entry, and std::runtime_error if the values are not strings
+    // or if they are compressed.
+    [[nodiscard]] std::vector<std::string_view> getStringViews(const std::string &key, uint32_t instance_id) const;
+
 private:
-    std::vector<uint8_t> m_bytes_data;
+    // Share the decoding of the records
+    friend class GBKFCoreStreamReader;
+
+    // Finds the end of the records and the index entries of the files to append to
+    friend class GBKFCoreWriter;
+
+    template<typename Target>
+    friend class GBKFCoreSchema;
+
+    struct KeyedRecordsIndex {
+        std::vector<GBKFCore::KeyedRecord> records;
+        std::unordered_map<std::string_view, std::vector<uint32_t> > records_by_key;
+    };
+
+    // Keeps alive the owned buffer or the memory mapping (null for non-owning views).
+    std::shared_ptr<const void> m_storage;
+    const uint8_t *m_bytes_data;
+    uint64_t m_bytes_size;
+
     std::vector<uint8_t> m_sha256_read;
-    std::vector<uint8_t> m_sha256_calculated;
+    std::shared_future<std::vector<uint8_t> > m_sha256_calculated;
 
     uint8_t m_gbkf_version;
     uint32_t m_specification_id;
@@ -52,79 +162,153 @@ private:
     uint8_t m_keys_size;
     uint32_t m_keyed_values_nb;
 
-    void readSha();
-
-    void readHeader();
+    mutable std::shared_ptr<const KeyedRecordsIndex> m_index;
 
-    [[nodiscard]] std::pair<std::string, uint64_t> readString1Byte(uint64_t start_pos, uint16_t max_size) const;
+    // Positions of the index block in the data, the buckets number is 0 without a valid block
+    uint64_t m_index_entries_pos;
+    uint64_t m_index_buckets_pos;
+    uint32_t m_index_buckets_nb;
 
-    [[nodiscard]] std::pair<std::string, uint64_t> readStringUTF8(uint64_t start_pos, uint16_t max_size) const;
+    // Null when the library is built without GBKF_STATS
+    std::shared_ptr<GBKFCore::StatsCounters> m_stats;
 
-    [[nodiscard]] std::pair<uint8_t, uint64_t> readUInt8(uint64_t start_pos) const;
+    void initStats();
 
-    [[nodiscard]] std::pair<uint16_t, uint64_t> readUInt16(uint64_t start_pos) const;
+    void init(const uint8_t *data,
+              uint64_t size,
+              std::shared_ptr<const void> storage,
+              GBKFCore::ShaVerification sha_verification);
 
-    [[nodiscard]] std::pair<uint32_t, uint64_t> readUInt32(uint64_t start_pos) const;
+    void readSha(GBKFCore::ShaVerification sha_verification);
 
-    [[nodiscard]] std::pair<uint64_t, uint64_t> readUInt64(uint64_t start_pos) const;
+    void readHeader();
 
-    [[nodiscard]] std::pair<float, uint64_t> readFloat32(uint64_t start_pos) const;
+    // Keeps the index block only if it matches the header and the records area
+    void readIndexBlock();
 
-    [[nodiscard]] std::pair<double, uint64_t> readFloat64(uint64_t start_pos) const;
+    [[nodiscard]] bool readIndexBlockAt(uint64_t trailer_pos);
 
-    [[nodiscard]] std::pair<std::vector<std::string>, uint64_t> readValuesString1Byte(
-        uint64_t start_pos,
-        uint32_t values_nb,
-        uint16_t max_size) const;
+    [[nodiscard]] const KeyedRecordsIndex &getIndex() const;
 
-    [[nodiscard]] std::pair<std::vector<std::string>, uint64_t> readValuesStringUTF8(
-        uint64_t start_pos,
-        uint32_t values_nb,
-        uint16_t max_size) const;
+    // The key up to its first null and to the keys size, as the keys of the records are read
+    [[nodiscard]] std::string_view normalizeKey(std::string_view key) const;
 
-    [[nodiscard]] std::pair<std::vector<std::string>, uint64_t> readValuesText1Byte(
-        uint64_t start_pos,
-        uint32_t values_nb) const;
+    [[nodiscard]] std::optional<GBKFCore::KeyedRecord> findKeyedRecord(const std::string &key,
+                                                                       uint32_t instance_id) const;
 
-    [[nodiscard]] std::pair<std::vector<std::string>, uint64_t> readValuesTextUTF8(
-        uint64_t start_pos,
-        uint32_t values_nb) const;
+    // Takes a normalized key. Throws std::runtime_error if the index block does not match the record it points to.
+    [[nodiscard]] std::optional<GBKFCore::KeyedRecord> findIndexedRecord(std::string_view key,
+                                                                         uint32_t instance_id) const;
 
-    [[nodiscard]] std::pair<std::vector<uint8_t>, uint64_t> readValuesBlob(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] GBKFCore::KeyedRecord readKeyedRecord(uint64_t start_pos) const;
 
-    [[nodiscard]] std::pair<std::vector<bool>, uint64_t> readValuesBool(
-        uint64_t start_pos, uint32_t values_nb, uint8_t last_byte_bools_nb) const;
+    // The string records store their values size in the first bytes of the values, which must be in the data.
+    [[nodiscard]] static uint64_t readValuesSize(const uint8_t *data, uint64_t size, const GBKFCore::KeyedRecord &record);
 
-    [[nodiscard]] std::pair<std::vector<int8_t>, uint64_t> readValuesInt8(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] static std::vector<std::string_view> readStringViews(const uint8_t *data,
+                                                                      const GBKFCore::KeyedRecord &record);
 
-    [[nodiscard]] std::pair<std::vector<int16_t>, uint64_t> readValuesInt16(
-        uint64_t start_pos, uint32_t values_nb) const;
+    // readKeyedEntry() on the reader data, counted in the stats.
+    // The compressed values are decompressed on threads_nb threads (see decompressValues).
+    template<typename Entry = GBKFCore::KeyedEntry>
+    [[nodiscard]] Entry decodeKeyedEntry(const GBKFCore::KeyedRecord &record,
+                                         const typename Entry::allocator_type &allocator = {},
+                                         unsigned int threads_nb = 0) const;
 
-    [[nodiscard]] std::pair<std::vector<int32_t>, uint64_t> readValuesInt32(
-        uint64_t start_pos, uint32_t values_nb) const;
+    // Values of a compressed record, with its chunks decompressed on up to threads_nb threads
+    // (0 for std::thread::hardware_concurrency()).
+    [[nodiscard]] static std::vector<uint8_t> decompressValues(const uint8_t *data,
+                                                               const GBKFCore::KeyedRecord &record,
+                                                               unsigned int threads_nb = 0);
 
-    [[nodiscard]] std::pair<std::vector<int64_t>, uint64_t> readValuesInt64(
-        uint64_t start_pos, uint32_t values_nb) const;
+    // Record of the decompressed values, which start at 0. Throws std::runtime_error if their size does not match.
+    [[nodiscard]] static GBKFCore::KeyedRecord decompressedRecord(const GBKFCore::KeyedRecord &record,
+                                                                  const std::vector<uint8_t> &values);
 
-    [[nodiscard]] std::pair<std::vector<uint8_t>, uint64_t> readValuesUInt8(
-        uint64_t start_pos, uint32_t values_nb) const;
+    // Instantiated for GBKFCore::KeyedEntry and GBKFCore::pmr::KeyedEntry.
+    template<typename Entry = GBKFCore::KeyedEntry>
+    [[nodiscard]] static Entry readKeyedEntry(const uint8_t *data,
+                                              const GBKFCore::KeyedRecord &record,
+                                              const typename Entry::allocator_type &allocator = {});
 
-    [[nodiscard]] std::pair<std::vector<uint16_t>, uint64_t> readValuesUInt16(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] static std::pair<uint8_t, uint64_t> readUInt8(const uint8_t *data, uint64_t start_pos);
 
-    [[nodiscard]] std::pair<std::vector<uint32_t>, uint64_t> readValuesUInt32(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] static std::pair<uint16_t, uint64_t> readUInt16(const uint8_t *data, uint64_t start_pos);
 
-    [[nodiscard]] std::pair<std::vector<uint64_t>, uint64_t> readValuesUInt64(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] static std::pair<uint32_t, uint64_t> readUInt32(const uint8_t *data, uint64_t start_pos);
 
-    [[nodiscard]] std::pair<std::vector<float>, uint64_t> readValuesFloat32(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] static std::pair<uint64_t, uint64_t> readUInt64(const uint8_t *data, uint64_t start_pos);
 
-    [[nodiscard]] std::pair<std::vector<double>, uint64_t> readValuesFloat64(
-        uint64_t start_pos, uint32_t values_nb) const;
+    [[nodiscard]] static std::pair<std::vector<bool>, uint64_t> readValuesBool(
+        const uint8_t *data, uint64_t start_pos, uint32_t values_nb, uint8_t last_byte_bools_nb);
 };
 
+template<typename T>
+GBKFCore::ValuesView<T> GBKFCoreReader::getValuesView(const std::string &key, const uint32_t instance_id) const {
+    const std::optional<GBKFCore::KeyedRecord> record = findKeyedRecord(key, instance_id);
+    if (!record) {
+        throw std::out_of_range("Keyed entry not found");
+    }
+
+    const GBKFCore::ValueType deduced_type = GBKFCore::KeyedEntry::deduceValueType<T>();
+    if (record->type != deduced_type &&
+        !(record->type == GBKFCore::ValueType::BLOB && deduced_type == GBKFCore::ValueType::UINT8)) {
+        throw std::runtime_error("Type mismatch on values view");
+    }
+
+    if (record->compressed) {
+        throw std::runtime_error("Compressed values have no view");
+    }
+
+    return {m_bytes_data + record->values_pos, record->values_nb};
+}
+
+template<typename T>
+GBKFCore::KeyedColumns<T> GBKFCoreReader::getKeyedColumns(const std::string &key) const {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Only fixed-width values are read as columns");
+
+    GBKFCore::KeyedColumns<T> columns;
+
+    const KeyedRecordsIndex &index = getIndex();
+    const auto found = index.records_by_key.find(key);
+    if (found == index.records_by_key.end()) {
+        return columns;
+    }
+
+    const GBKFCore::ValueType deduced_type = GBKFCore::KeyedEntry::deduceValueType<T>();
+    uint64_t values_nb = 0;
+    for (const uint32_t record_nb: found->second) {
+        const GBKFCore::KeyedRecord &record = index.records[record_nb];
+        if (record.type != deduced_type &&
+            !(record.type == GBKFCore::ValueType::BLOB && deduced_type == GBKFCore::ValueType::UINT8)) {
+            throw std::runtime_error("Type mismatch on keyed columns");
+        }
+        values_nb += record.values_nb;
+    }
+
+    columns.instance_ids.reserve(found->second.size());
+    columns.values_offsets.reserve(found->second.size() + 1);
+    columns.values.resize(values_nb);
+
+    uint64_t values_pos = 0;
+    for (const uint32_t record_nb: found->second) {
+        const GBKFCore::KeyedRecord &record = index.records[record_nb];
+        if (record.compressed) {
+            const std::vector<uint8_t> values = decompressValues(m_bytes_data, record);
+            const GBKFCore::KeyedRecord values_record = decompressedRecord(record, values);
+            std::memcpy(columns.values.data() + values_pos, values.data(), values_record.end_pos);
+        } else if (record.values_nb > 0) {
+            std::memcpy(columns.values.data() + values_pos,
+                        m_bytes_data + record.values_pos,
+                        static_cast<size_t>(record.values_nb) * sizeof(T));
+        }
+        values_pos += record.values_nb;
+
+        columns.instance_ids.push_back(record.instance_id);
+        columns.values_offsets.push_back(values_pos);
+    }
+
+    return columns;
+}
+
 #endif // GBKF_CORE_READER_HXX
@@ -0,0 +1,245 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_SCHEMA_HXX
+#define GBKF_CORE_SCHEMA_HXX
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreReader.hxx"
+
+// Known layout of the files of a specification version: the records are frames of the same keys and types,
+// always in the same order, e.g. A, B, C, A, B, C... Each record is checked against its slot of the layout
+// and decoded straight into a field of Target, without maps, entries nor type dispatch.
+//
+// Usage:
+//      struct Frame { uint32_t id; double time; std::vector<float> samples; };
+//
+//      GBKFCoreSchema<Frame> schema(spec_id, spec_version);
+//      schema.setInstanceIdField(&Frame::id).addField("T", &Frame::time).addField("S", &Frame::samples);
+//      std::vector<Frame> frames = schema.decode(reader);
+template<typename Target>
+class GBKFCoreSchema {
+public:
+    GBKFCoreSchema(const uint32_t specification_id, const uint16_t specification_version)
+        : m_specification_id(specification_id), m_specification_version(specification_version) {
+    }
+
+    [[nodiscard]] uint32_t getSpecificationID() const {
+        return m_specification_id;
+    }
+
+    [[nodiscard]] uint16_t getSpecificationVersion() const {
+        return m_specification_version;
+    }
+
+    // Receives the instance id of the first record of each frame.
+    GBKFCoreSchema &setInstanceIdField(uint32_t Target::*field) {
+        m_instance_id_field = field;
+        return *this;
+    }
+
+    // Next slot of the layout, with a single value. T is a fixed-width type or std::string.
+    template<typename T>
+    GBKFCoreSchema &addField(const std::string &key, T Target::*field) {
+        static_assert((std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, std::string>,
+                      "Single value fields are fixed-width values or strings");
+
+        addSlot<T>(key, true, [field](const uint8_t *data, const GBKFCore::KeyedRecord &record, Target &target) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                target.*field = std::string(GBKFCoreReader::readStringViews(data, record).front());
+            } else {
+                std::memcpy(&(target.*field), data + record.values_pos, sizeof(T));
+            }
+        });
+        return *this;
+    }
+
+    // Next slot of the layout, with any number of values, which are appended to the vector.
+    // T is a fixed-width type, bool or std::string.
+    template<typename T>
+    GBKFCoreSchema &addField(const std::string &key, std::vector<T> Target::*field) {
+        addSlot<T>(key, false, [field](const uint8_t *data, const GBKFCore::KeyedRecord &record, Target &target) {
+            std::vector<T> &values = target.*field;
+
+            if constexpr (std::is_same_v<T, std::string>) {
+                for (const std::string_view value: GBKFCoreReader::readStringViews(data, record)) {
+                    values.emplace_back(value);
+                }
+            } else if constexpr (std::is_same_v<T, bool>) {
+                const std::vector<bool> bools = GBKFCoreReader::readValuesBool(
+                    data, record.values_pos + 1, record.values_nb, data[record.values_pos]).first;
+                values.insert(values.end(), bools.begin(), bools.end());
+            } else {
+                const size_t previous_size = values.size();
+                values.resize(previous_size + record.values_nb);
+                if (record.values_nb > 0) {
+                    std::memcpy(values.data() + previous_size,
+                                data + record.values_pos,
+                                static_cast<size_t>(record.values_nb) * sizeof(T));
+                }
+            }
+        });
+
+        m_slots.back().reserve = [field](const uint64_t values_nb, Target &target) {
+            (target.*field).reserve((target.*field).size() + values_nb);
+        };
+        return *this;
+    }
+
+    // One target per frame. Throws std::runtime_error if the specification or a record does not match.
+    [[nodiscard]] std::vector<Target> decode(const GBKFCoreReader &reader) const {
+        std::vector<Target> targets(framesNb(reader));
+        decodeFrames(reader, [&targets](const size_t frame_nb) -> Target & {
+            return targets[frame_nb];
+        });
+        return targets;
+    }
+
+    // Every frame into the same target, so the vector fields become columns of all the frames,
+    // and the single value fields keep the last frame. The columns are reserved from the record headers first.
+    void decodeColumns(const GBKFCoreReader &reader, Target &columns) const {
+        (void) framesNb(reader);
+        reserveColumns(reader, columns);
+        decodeFrames(reader, [&columns](size_t) -> Target & {
+            return columns;
+        });
+    }
+
+private:
+    struct Slot {
+        std::string key;
+        GBKFCore::ValueType type;
+        bool single_value;
+        std::function<void(uint64_t, Target &)> reserve; // Null for the single value fields
+        std::function<void(const uint8_t *, const GBKFCore::KeyedRecord &, Target &)> decode;
+    };
+
+    uint32_t m_specification_id;
+    uint16_t m_specification_version;
+    uint32_t Target::*m_instance_id_field = nullptr;
+    std::vector<Slot> m_slots;
+
+    template<typename T, typename Function>
+    void addSlot(const std::string &key, const bool single_value, Function &&decode) {
+        m_slots.push_back({key,
+                           GBKFCore::KeyedEntry::deduceValueType<T>(),
+                           single_value,
+                           nullptr,
+                           std::forward<Function>(decode)});
+    }
+
+    // Sums the values number of each slot, reading only the record headers, so each column grows once.
+    void reserveColumns(const GBKFCoreReader &reader, Target &columns) const {
+        std::vector<uint64_t> values_nbs(m_slots.size(), 0);
+
+        uint64_t current_pos = GBKFCore::Header::SIZE;
+        for (uint32_t record_nb = 0; record_nb < reader.getKeyedValuesNb(); ++record_nb) {
+            const GBKFCore::KeyedRecord record = reader.readKeyedRecord(current_pos);
+            current_pos = record.end_pos;
+            values_nbs[record_nb % m_slots.size()] += record.values_nb;
+        }
+
+        for (size_t slot_nb = 0; slot_nb < m_slots.size(); ++slot_nb) {
+            if (m_slots[slot_nb].reserve) {
+                m_slots[slot_nb].reserve(values_nbs[slot_nb], columns);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t framesNb(const GBKFCoreReader &reader) const {
+        if (reader.getSpecificationID() != m_specification_id ||
+            reader.getSpecificationVersion() != m_specification_version) {
+            throw std::runtime_error("Specification mismatch with the schema");
+        }
+
+        if (m_slots.empty() || reader.getKeyedValuesNb() % m_slots.size() != 0) {
+            throw std::runtime_error("Records number mismatch with the schema");
+        }
+
+        return reader.getKeyedValuesNb() / m_slots.size();
+    }
+
+    template<typename TargetOf>
+    void decodeFrames(const GBKFCoreReader &reader, TargetOf &&target_of) const {
+        const uint8_t *data = reader.m_bytes_data;
+
+        uint64_t current_pos = GBKFCore::Header::SIZE;
+        for (uint32_t record_nb = 0; record_nb < reader.getKeyedValuesNb(); ++record_nb) {
+            const Slot &slot = m_slots[record_nb % m_slots.size()];
+
+            const GBKFCore::KeyedRecord record = reader.readKeyedRecord(current_pos);
+            current_pos = record.end_pos;
+
+            const bool type_matches = record.type == slot.type ||
+                                      (record.type == GBKFCore::ValueType::BLOB &&
+                                       slot.type == GBKFCore::ValueType::UINT8);
+
+            if (record.key != slot.key || !type_matches || (slot.single_value && record.values_nb != 1)) {
+                throw std::runtime_error("Record mismatch with the schema");
+            }
+
+            Target &target = target_of(record_nb / m_slots.size());
+            if (m_instance_id_field != nullptr && record_nb % m_slots.size() == 0) {
+                target.*m_instance_id_field = record.instance_id;
+            }
+
+            if (record.compressed) {
+                const std::vector<uint8_t> values = GBKFCoreReader::decompressValues(data, record);
+                slot.decode(values.data(), GBKFCoreReader::decompressedRecord(record, values), target);
+            } else {
+                slot.decode(data, record, target);
+            }
+        }
+    }
+};
+
+// Schemas of the versions of the specifications that decode into the same Target.
+template<typename Target>
+class GBKFCoreSchemaRegistry {
+public:
+    // Replaces the schema of the same specification version.
+    void add(GBKFCoreSchema<Target> schema) {
+        const auto version = std::make_pair(schema.getSpecificationID(), schema.getSpecificationVersion());
+        m_schemas.insert_or_assign(version, std::move(schema));
+    }
+
+    // Throws std::out_of_range if no schema is registered for the specification version of the reader.
+    [[nodiscard]] const GBKFCoreSchema<Target> &find(const GBKFCoreReader &reader) const {
+        const auto found = m_schemas.find(std::make_pair(reader.getSpecificationID(),
+                                                         reader.getSpecificationVersion()));
+        if (found == m_schemas.end()) {
+            throw std::out_of_range("No schema for the specification version");
+        }
+        return found->second;
+    }
+
+    [[nodiscard]] std::vector<Target> decode(const GBKFCoreReader &reader) const {
+        return find(reader).decode(reader);
+    }
+
+private:
+    std::map<std::pair<uint32_t, uint16_t>, GBKFCoreSchema<Target> > m_schemas;
+};
+
+#endif // GBKF_CORE_SCHEMA_HXX
@@ -0,0 +1,217 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_SHA256_HXX
+#define GBKF_CORE_SHA256_HXX
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#ifdef USE_OPEN_SSL
+    #include <openssl/sha.h>
+#else
+    #include "GBKF/picosha2.hxx"
+    #include "GBKF/GBKFCoreSha256Hardware.hxx"
+#endif
+
+#include "GBKF/GBKFCore.hxx"
+
+namespace GBKFCore {
+
+    // Incremental SHA-256, used to compute and verify the GBKF footer.
+    // Without OpenSSL, the blocks are processed with the SHA CPU instructions when available
+    // (see GBKFCoreSha256Hardware.hxx), otherwise with PicoSha2.
+    // The state can be copied to keep snapshots, and digest() does not modify it,
+    // so more data can be added after reading an intermediate digest.
+    class Sha256 {
+    public:
+        Sha256();
+
+        // With allow_hardware=false, the blocks are always processed with PicoSha2, the portable path
+        // (e.g. to check the SHA CPU instructions against it). OpenSSL ignores it.
+        explicit Sha256(bool allow_hardware);
+
+        void update(const uint8_t *data, uint64_t size);
+
+        [[nodiscard]] std::vector<uint8_t> digest() const;
+
+        [[nodiscard]] static std::vector<uint8_t> hash(const uint8_t *data, uint64_t size);
+
+        // True when the hash uses the SHA CPU instructions (always true with OpenSSL, which picks its own).
+        [[nodiscard]] static bool isHardwareAccelerated();
+
+    private:
+#ifdef USE_OPEN_SSL
+        SHA256_CTX m_context{};
+#else
+        static constexpr uint64_t BLOCK_SIZE = 64;
+
+        uint32_t m_state[8]{};
+        uint8_t m_block[BLOCK_SIZE]{};
+        uint64_t m_block_size = 0;
+        uint64_t m_length = 0;
+        bool m_hardware = false;
+
+        static void processBlocks(uint32_t *state, const uint8_t *data, uint64_t blocks_nb, bool hardware);
+#endif
+    };
+
+#ifdef USE_OPEN_SSL
+
+    // The SHA256_* functions are deprecated since OpenSSL 3.0, but SHA256_CTX can be copied for the snapshots.
+#if defined(__GNUC__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+    inline Sha256::Sha256() {
+        SHA256_Init(&m_context);
+    }
+
+    inline Sha256::Sha256(bool) : Sha256() {}
+
+    inline void Sha256::update(const uint8_t *data, const uint64_t size) {
+        SHA256_Update(&m_context, data, size);
+    }
+
+    inline std::vector<uint8_t> Sha256::digest() const {
+        SHA256_CTX context = m_context;
+        std::vector<uint8_t> sha256(FOOTER_SIZE);
+        SHA256_Final(sha256.data(), &context);
+        return sha256;
+    }
+
+    inline bool Sha256::isHardwareAccelerated() {
+        return true;
+    }
+
+#if defined(__GNUC__)
+    #pragma GCC diagnostic pop
+#endif
+
+#else
+
+    inline Sha256::Sha256() : Sha256(true) {}
+
+    inline Sha256::Sha256(const bool allow_hardware) : m_hardware(allow_hardware && isHardwareAccelerated()) {
+        for (size_t i = 0; i < 8; ++i) {
+            m_state[i] = static_cast<uint32_t>(picosha2::detail::initial_message_digest[i]);
+        }
+    }
+
+    inline void Sha256::update(const uint8_t *data, uint64_t size) {
+        if (size == 0) {
+            return;
+        }
+
+        m_length += size;
+
+        // Complete the pending block
+        if (m_block_size > 0) {
+            const uint64_t copy_size = std::min(size, BLOCK_SIZE - m_block_size);
+            std::memcpy(m_block + m_block_size, data, copy_size);
+            m_block_size += copy_size;
+            data += copy_size;
+            size -= copy_size;
+
+            if (m_block_size < BLOCK_SIZE) {
+                return;
+            }
+
+            processBlocks(m_state, m_block, 1, m_hardware);
+            m_block_size = 0;
+        }
+
+        // Process the full blocks straight from the input, without copy
+        const uint64_t blocks_nb = size / BLOCK_SIZE;
+        processBlocks(m_state, data, blocks_nb, m_hardware);
+        data += blocks_nb * BLOCK_SIZE;
+        size -= blocks_nb * BLOCK_SIZE;
+
+        // Keep the remaining bytes for the next call
+        std::memcpy(m_block, data, size);
+        m_block_size = size;
+    }
+
+    inline std::vector<uint8_t> Sha256::digest() const {
+        uint32_t state[8];
+        std::memcpy(state, m_state, sizeof(state));
+
+        // Padding: 0x80, zeros, and the big-endian length in bits
+        uint8_t tail[BLOCK_SIZE * 2]{};
+        std::memcpy(tail, m_block, m_block_size);
+        tail[m_block_size] = 0x80;
+
+        const uint64_t tail_size = m_block_size + 1 + 8 <= BLOCK_SIZE ? BLOCK_SIZE : BLOCK_SIZE * 2;
+        const uint64_t bits_length = m_length * 8;
+        for (size_t i = 0; i < 8; ++i) {
+            tail[tail_size - 1 - i] = static_cast<uint8_t>(bits_length >> (8 * i));
+        }
+
+        processBlocks(state, tail, tail_size / BLOCK_SIZE, m_hardware);
+
+        std::vector<uint8_t> sha256(FOOTER_SIZE);
+        for (size_t i = 0; i < 8; ++i) {
+            sha256[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+            sha256[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+            sha256[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+            sha256[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+        }
+        return sha256;
+    }
+
+    inline bool Sha256::isHardwareAccelerated() {
+        return Sha256Hardware::isSupported();
+    }
+
+    inline void Sha256::processBlocks(uint32_t *state,
+                                      const uint8_t *data,
+                                      const uint64_t blocks_nb,
+                                      [[maybe_unused]] const bool hardware) {
+        if (blocks_nb == 0) {
+            return;
+        }
+
+#if defined(GBKF_SHA256_HARDWARE_X86) || defined(GBKF_SHA256_HARDWARE_ARM)
+        if (hardware) {
+            Sha256Hardware::processBlocks(state, data, blocks_nb);
+            return;
+        }
+#endif
+
+        picosha2::word_t words_state[8];
+        std::copy(state, state + 8, words_state);
+
+        for (uint64_t i = 0; i < blocks_nb; ++i) {
+            const uint8_t *block = data + i * BLOCK_SIZE;
+            picosha2::detail::hash256_block(words_state, block, block + BLOCK_SIZE);
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            state[i] = static_cast<uint32_t>(words_state[i]);
+        }
+    }
+
+#endif
+
+    inline std::vector<uint8_t> Sha256::hash(const uint8_t *data, const uint64_t size) {
+        Sha256 sha256;
+        sha256.update(data, size);
+        return sha256.digest();
+    }
+}
+
+#endif // GBKF_CORE_SHA256_HXX
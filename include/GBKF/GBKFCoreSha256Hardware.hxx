@@ -0,0 +1,170 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_SHA256_HARDWARE_HXX
+#define GBKF_CORE_SHA256_HARDWARE_HXX
+
+#include <cstdint>
+
+// SHA-256 block processing with the CPU instructions:
+//  + x86 SHA extensions (SHA-NI), compiled with GCC or Clang and detected at runtime.
+//  + ARMv8 SHA2 extensions, when the compiler targets them (e.g. -march=armv8-a+crypto, or Apple Silicon).
+//
+// Define GBKF_NO_SHA256_HARDWARE to always use the portable implementation.
+
+#if !defined(GBKF_NO_SHA256_HARDWARE) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define GBKF_SHA256_HARDWARE_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#elif !defined(GBKF_NO_SHA256_HARDWARE) && defined(__aarch64__) && \
+      (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+    #define GBKF_SHA256_HARDWARE_ARM
+    #include <arm_neon.h>
+#endif
+
+namespace GBKFCore::Sha256Hardware {
+
+    alignas(16) constexpr uint32_t ROUND_CONSTANTS[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+#if defined(GBKF_SHA256_HARDWARE_X86)
+
+    inline bool detectSupport() {
+        unsigned int eax, ebx, ecx, edx;
+
+        // SSSE3 and SSE4.1 are used to shuffle the words
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1)) {
+            return false;
+        }
+
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+    }
+
+    __attribute__((target("sha,ssse3,sse4.1")))
+    inline void processBlocks(uint32_t *state, const uint8_t *data, const uint64_t blocks_nb) {
+        const __m128i byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        // The instructions work on the state as ABEF and CDGH
+        __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xB1);
+        __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1B);
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+        for (uint64_t block_nb = 0; block_nb < blocks_nb; ++block_nb) {
+            const uint8_t *block = data + block_nb * 64;
+            const __m128i abef_save = state0;
+            const __m128i cdgh_save = state1;
+
+            // The message schedule is kept as 4 groups of 4 words, each group is replaced once used
+            __m128i words[4];
+            for (int i = 0; i < 4; ++i) {
+                words[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16)),
+                                            byte_swap_mask);
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                __m128i words_constants = _mm_add_epi32(
+                    words[i % 4], _mm_load_si128(reinterpret_cast<const __m128i *>(ROUND_CONSTANTS + i * 4)));
+
+                state1 = _mm_sha256rnds2_epu32(state1, state0, words_constants);
+                words_constants = _mm_shuffle_epi32(words_constants, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, words_constants);
+
+                if (i < 12) {
+                    tmp = _mm_sha256msg1_epu32(words[i % 4], words[(i + 1) % 4]);
+                    tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(words[(i + 3) % 4], words[(i + 2) % 4], 4));
+                    words[i % 4] = _mm_sha256msg2_epu32(tmp, words[(i + 3) % 4]);
+                }
+            }
+
+            state0 = _mm_add_epi32(state0, abef_save);
+            state1 = _mm_add_epi32(state1, cdgh_save);
+        }
+
+        // Back to ABCD and EFGH
+        tmp = _mm_shuffle_epi32(state0, 0x1B);
+        state1 = _mm_shuffle_epi32(state1, 0xB1);
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+        state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(state), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), state1);
+    }
+
+#elif defined(GBKF_SHA256_HARDWARE_ARM)
+
+    inline bool detectSupport() {
+        // Guaranteed by the compilation target
+        return true;
+    }
+
+    inline void processBlocks(uint32_t *state, const uint8_t *data, const uint64_t blocks_nb) {
+        uint32x4_t state0 = vld1q_u32(state);
+        uint32x4_t state1 = vld1q_u32(state + 4);
+
+        for (uint64_t block_nb = 0; block_nb < blocks_nb; ++block_nb) {
+            const uint8_t *block = data + block_nb * 64;
+            const uint32x4_t abcd_save = state0;
+            const uint32x4_t efgh_save = state1;
+
+            // The message schedule is kept as 4 groups of 4 words, each group is replaced once used
+            uint32x4_t words[4];
+            for (int i = 0; i < 4; ++i) {
+                words[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + i * 16)));
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                const uint32x4_t words_constants = vaddq_u32(words[i % 4], vld1q_u32(ROUND_CONSTANTS + i * 4));
+
+                if (i < 12) {
+                    words[i % 4] = vsha256su1q_u32(vsha256su0q_u32(words[i % 4], words[(i + 1) % 4]),
+                                                   words[(i + 2) % 4],
+                                                   words[(i + 3) % 4]);
+                }
+
+                const uint32x4_t abcd = state0;
+                state0 = vsha256hq_u32(state0, state1, words_constants);
+                state1 = vsha256h2q_u32(state1, abcd, words_constants);
+            }
+
+            state0 = vaddq_u32(state0, abcd_save);
+            state1 = vaddq_u32(state1, efgh_save);
+        }
+
+        vst1q_u32(state, state0);
+        vst1q_u32(state + 4, state1);
+    }
+
+#endif
+
+    // True when processBlocks() is available on this build and CPU, detected once.
+    inline bool isSupported() {
+#if defined(GBKF_SHA256_HARDWARE_X86) || defined(GBKF_SHA256_HARDWARE_ARM)
+        static const bool supported = detectSupport();
+        return supported;
+#else
+        return false;
+#endif
+    }
+}
+
+#endif // GBKF_CORE_SHA256_HARDWARE_HXX
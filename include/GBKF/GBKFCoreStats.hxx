@@ -0,0 +1,136 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_STATS_HXX
+#define GBKF_CORE_STATS_HXX
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace GBKFCore {
+
+    // Counters of a reader or a writer. They are only collected when the libraries are built with the CMake
+    // option GBKF_STATS, otherwise the hot paths are not instrumented at all and every counter stays at 0.
+    struct Stats {
+        bool enabled = false;
+
+        uint64_t bytes_read = 0;    // Loaded or mapped from files
+        uint64_t bytes_written = 0; // Written to files
+
+        // Records decoded (reader) or encoded (writer), in total and by ValueType number
+        uint64_t records_nb = 0;
+        std::array<uint64_t, 256> records_nb_by_type{};
+
+        // Reader: values vectors and strings allocated by the decoding (short strings may not allocate).
+        // Writer: reallocations of the bytes buffer.
+        uint64_t allocations_nb = 0;
+
+        // Times, in nanoseconds. The scan, decode and insert times are only measured by the reader.
+        uint64_t io_ns = 0;
+        uint64_t hash_ns = 0;
+        uint64_t scan_ns = 0;   // Reading the records headers and skipping their values
+        uint64_t decode_ns = 0; // Decoding the values into entries
+        uint64_t insert_ns = 0; // Inserting the entries into the maps of getKeyedEntries()
+    };
+
+    // Shared by the threads of a reader or a writer (background hash, parallel decode, asynchronous writes).
+    struct StatsCounters {
+        std::atomic<uint64_t> bytes_read{0};
+        std::atomic<uint64_t> bytes_written{0};
+        std::atomic<uint64_t> records_nb{0};
+        std::array<std::atomic<uint64_t>, 256> records_nb_by_type{};
+        std::atomic<uint64_t> allocations_nb{0};
+        std::atomic<uint64_t> io_ns{0};
+        std::atomic<uint64_t> hash_ns{0};
+        std::atomic<uint64_t> scan_ns{0};
+        std::atomic<uint64_t> decode_ns{0};
+        std::atomic<uint64_t> insert_ns{0};
+
+        void addRecord(const uint8_t type_nb, const uint64_t allocations = 0) {
+            records_nb.fetch_add(1, std::memory_order_relaxed);
+            records_nb_by_type[type_nb].fetch_add(1, std::memory_order_relaxed);
+            allocations_nb.fetch_add(allocations, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] Stats snapshot() const {
+            Stats stats;
+            stats.enabled = true;
+            stats.bytes_read = bytes_read.load(std::memory_order_relaxed);
+            stats.bytes_written = bytes_written.load(std::memory_order_relaxed);
+            stats.records_nb = records_nb.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < records_nb_by_type.size(); ++i) {
+                stats.records_nb_by_type[i] = records_nb_by_type[i].load(std::memory_order_relaxed);
+            }
+            stats.allocations_nb = allocations_nb.load(std::memory_order_relaxed);
+            stats.io_ns = io_ns.load(std::memory_order_relaxed);
+            stats.hash_ns = hash_ns.load(std::memory_order_relaxed);
+            stats.scan_ns = scan_ns.load(std::memory_order_relaxed);
+            stats.decode_ns = decode_ns.load(std::memory_order_relaxed);
+            stats.insert_ns = insert_ns.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void reset() {
+            for (auto *counter: {&bytes_read, &bytes_written, &records_nb, &allocations_nb,
+                                 &io_ns, &hash_ns, &scan_ns, &decode_ns, &insert_ns}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+            for (auto &counter: records_nb_by_type) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Adds the time of its scope to a counter.
+    class StatsTimer {
+    public:
+        explicit StatsTimer(std::atomic<uint64_t> &counter)
+            : m_counter(counter), m_start(std::chrono::steady_clock::now()) {
+        }
+
+        StatsTimer(const StatsTimer &) = delete;
+
+        StatsTimer &operator=(const StatsTimer &) = delete;
+
+        ~StatsTimer() {
+            const auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_counter.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> &m_counter;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
+// Instrumentation of the library sources, the arguments are not evaluated without GBKF_STATS.
+#define GBKF_STATS_CONCAT_IMPL(a, b) a##b
+#define GBKF_STATS_CONCAT(a, b) GBKF_STATS_CONCAT_IMPL(a, b)
+
+#ifdef GBKF_STATS
+    #define GBKF_STATS_TIMER(stats, counter) \
+        const GBKFCore::StatsTimer GBKF_STATS_CONCAT(gbkf_stats_timer_, __LINE__)((stats)->counter)
+    #define GBKF_STATS_ADD(stats, counter, value) \
+        (stats)->counter.fetch_add((value), std::memory_order_relaxed)
+    #define GBKF_STATS_RECORD(stats, type_nb, allocations) (stats)->addRecord((type_nb), (allocations))
+#else
+    #define GBKF_STATS_TIMER(stats, counter) static_cast<void>(0)
+    #define GBKF_STATS_ADD(stats, counter, value) static_cast<void>(0)
+    #define GBKF_STATS_RECORD(stats, type_nb, allocations) static_cast<void>(0)
+#endif
+
+#endif // GBKF_CORE_STATS_HXX
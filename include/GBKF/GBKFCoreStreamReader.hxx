@@ -0,0 +1,107 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#ifndef GBKF_CORE_STREAM_READER_HXX
+#define GBKF_CORE_STREAM_READER_HXX
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreSha256.hxx"
+
+// Forward-only reader, it keeps in memory only the record being read.
+//
+// Usage:
+//      while (reader.nextRecord()) {
+//          const KeyedRecord &record = reader.getRecord();
+//          ... reader.readEntry() or reader.skipEntry()
+//      }
+//      reader.verifiesSha();
+class GBKFCoreStreamReader {
+public:
+    explicit GBKFCoreStreamReader(std::istream &stream);
+
+    explicit GBKFCoreStreamReader(const std::string &read_path);
+
+    [[nodiscard]] uint8_t getGBKFVersion() const;
+
+    [[nodiscard]] uint32_t getSpecificationID() const;
+
+    [[nodiscard]] uint16_t getSpecificationVersion() const;
+
+    [[nodiscard]] uint8_t getKeysSize() const;
+
+    [[nodiscard]] uint32_t getKeyedValuesNb() const;
+
+    // Reads the header of the next record, the values of the current record are skipped if they were not read.
+    // Returns false after the last record, once the footer was read.
+    bool nextRecord();
+
+    // The key is a view that remains valid until the next call to nextRecord().
+    // The positions are relative to the record values, not to the stream.
+    [[nodiscard]] const GBKFCore::KeyedRecord &getRecord() const;
+
+    // Reads and decodes the values of the current record.
+    [[nodiscard]] GBKFCore::KeyedEntry readEntry();
+
+    // Reads the values of the current record as views, valid until the next call to nextRecord().
+    // Throws std::runtime_error if the values are not strings.
+    [[nodiscard]] std::vector<std::string_view> readStringViews();
+
+    // Reads the values of the current record without decoding them (they still are hashed).
+    void skipEntry();
+
+    // Only true once nextRecord() returned false and the footer matches the data.
+    [[nodiscard]] bool verifiesSha() const;
+
+private:
+    static constexpr uint64_t SKIP_CHUNK_SIZE = 64 * 1024;
+
+    std::unique_ptr<std::istream> m_owned_stream;
+    std::istream &m_stream;
+
+    GBKFCore::Sha256 m_sha256;
+    std::vector<uint8_t> m_sha256_read;
+    std::vector<uint8_t> m_sha256_calculated;
+
+    uint8_t m_gbkf_version;
+    uint32_t m_specification_id;
+    uint16_t m_specification_version;
+    uint8_t m_keys_size;
+    uint32_t m_keyed_values_nb;
+
+    uint32_t m_records_read;
+    bool m_values_pending;
+    bool m_finished;
+
+    GBKFCore::KeyedRecord m_record;
+    std::string m_key;
+    std::vector<uint8_t> m_values;
+    std::vector<uint8_t> m_decompressed_values; // Of the current record, when it is compressed
+
+    void readHeader();
+
+    void readFooter();
+
+    void readBytes(uint8_t *destination, uint64_t size);
+
+    // Reads the values of the current record, which are kept when decode is true.
+    void readValues(bool decode);
+};
+
+#endif // GBKF_CORE_STREAM_READER_HXX
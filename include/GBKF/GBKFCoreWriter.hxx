@@ -17,13 +17,57 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <future>
+#include <memory>
+#include <unordered_set>
 #include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreSha256.hxx"
+#include "GBKF/GBKFCoreStats.hxx"
 
 class GBKFCoreWriter {
 public:
+    static constexpr uint64_t DEFAULT_STREAM_BUFFER_SIZE = 4 * 1024 * 1024;
+
+    // Size of the chunks hashed and written at once by write()
+    static constexpr uint64_t WRITE_CHUNK_SIZE = 1024 * 1024;
+
     GBKFCoreWriter();
 
+    // Streaming mode: the records are flushed to the file each time the buffer exceeds stream_buffer_size,
+    // and the file is completed by close(). write() and getBytesBuffer() are not available in this mode.
+    //
+    // The SHA-256 is computed while flushing if the header does not change after the first flush,
+    // (e.g. by calling setKeyedValuesNb() up-front and close(false)). Otherwise, close() reads the file back.
+    //
+    // With async_buffers_nb > 0, the full buffers are written and hashed by a background thread, so adding
+    // keyed-values does not wait for the disk. Up to async_buffers_nb full buffers can wait to be written,
+    // then adding keyed-values waits for one of them (back-pressure). The errors of the background thread
+    // are thrown by the next flush or by close().
+    explicit GBKFCoreWriter(const std::string &write_path,
+                            uint64_t stream_buffer_size = DEFAULT_STREAM_BUFFER_SIZE,
+                            uint32_t async_buffers_nb = 0);
+
+    // Streaming writer that appends records to an existing file, without rewriting it: the new records are written
+    // over the footer (and the index block, which is rebuilt with the old and new entries), then close() patches the
+    // keyed-values number of the header and appends the new footer. The header keeps its values until changed.
+    //
+    // The footer hashes the header first, so it can not be resumed from the previous one: close() reads the file back
+    // to hash it once. The footer of the existing file is verified before appending, unless it was written without.
+    // reset() discards the existing records too. Throws std::runtime_error if the file can not be read or appended,
+    // or if its footer does not match its data, without changing the file.
+    [[nodiscard]] static GBKFCoreWriter openAppend(const std::string &path,
+                                                   uint64_t stream_buffer_size = DEFAULT_STREAM_BUFFER_SIZE,
+                                                   uint32_t async_buffers_nb = 0);
+
+    GBKFCoreWriter(GBKFCoreWriter &&) noexcept;
+
+    // An open stream of this writer is closed first, as by the destructor (call close() to handle its errors).
+    GBKFCoreWriter &operator=(GBKFCoreWriter &&other) noexcept;
+
+    ~GBKFCoreWriter();
+
     void reset();
 
     void setGBKFVersion(uint8_t value = 0);
@@ -38,8 +82,23 @@ public:
 
     void setKeyedValuesNbAuto();
 
+    // Pre-allocates the buffer for bytes more bytes of keyed-values (on top of the ones already in the buffer),
+    // the index block and the footer. With the index block, the index of as many records as the bytes can hold
+    // is reserved, use reserveRecords() when the records number is known.
+    void reserve(uint64_t bytes);
+
+    // Pre-allocates the buffer for records_nb keyed-values of values_size bytes each, their index block and
+    // the footer (set the keys size and the index block before calling it).
+    void reserveRecords(uint64_t records_nb, uint64_t values_size = 0);
+
     void addKeyedValuesBoolean(const std::string &key, uint32_t instance_id, const std::vector<bool> &values);
 
+    // Packs the booleans with SIMD instructions when available (see GBKFCoreBitmap.hxx).
+    void addKeyedValuesBoolean(const std::string &key, uint32_t instance_id, const bool *values, uint32_t values_nb);
+
+    // Booleans already packed LSB-first, copied as they are. The bits after bits_nb are written as 0.
+    void addKeyedValuesBitmap(const std::string &key, uint32_t instance_id, const uint8_t *packed, uint32_t bits_nb);
+
     void addKeyedValuesStringUTF8(const std::string &key,
                                   uint32_t instance_id,
                                   const std::vector<std::string> &values,
@@ -47,44 +106,170 @@ public:
 
     void addKeyedValuesBlob(const std::string &key, uint32_t instance_id, const std::vector<uint8_t> &values);
 
+    // The pointer overloads copy values_nb values from any contiguous memory (array, mapped file, ...).
+    void addKeyedValuesBlob(const std::string &key, uint32_t instance_id, const uint8_t *values, uint32_t values_nb);
+
     void addKeyedValuesInt8(const std::string &key, uint32_t instance_id, const std::vector<int8_t> &values);
 
+    void addKeyedValuesInt8(const std::string &key, uint32_t instance_id, const int8_t *values, uint32_t values_nb);
+
     void addKeyedValuesInt16(const std::string &key, uint32_t instance_id, const std::vector<int16_t> &values);
 
+    void addKeyedValuesInt16(const std::string &key, uint32_t instance_id, const int16_t *values, uint32_t values_nb);
+
     void addKeyedValuesInt32(const std::string &key, uint32_t instance_id, const std::vector<int32_t> &values);
 
+    void addKeyedValuesInt32(const std::string &key, uint32_t instance_id, const int32_t *values, uint32_t values_nb);
+
     void addKeyedValuesInt64(const std::string &key, uint32_t instance_id, const std::vector<int64_t> &values);
 
+    void addKeyedValuesInt64(const std::string &key, uint32_t instance_id, const int64_t *values, uint32_t values_nb);
+
     void addKeyedValuesUInt8(const std::string &key, uint32_t instance_id, const std::vector<uint8_t> &values);
 
+    void addKeyedValuesUInt8(const std::string &key, uint32_t instance_id, const uint8_t *values, uint32_t values_nb);
+
     void addKeyedValuesUInt16(const std::string &key, uint32_t instance_id, const std::vector<uint16_t> &values);
 
+    void addKeyedValuesUInt16(const std::string &key, uint32_t instance_id, const uint16_t *values, uint32_t values_nb);
+
     void addKeyedValuesUInt32(const std::string &key, uint32_t instance_id, const std::vector<uint32_t> &values);
 
+    void addKeyedValuesUInt32(const std::string &key, uint32_t instance_id, const uint32_t *values, uint32_t values_nb);
+
     void addKeyedValuesUInt64(const std::string &key, uint32_t instance_id, const std::vector<uint64_t> &values);
 
+    void addKeyedValuesUInt64(const std::string &key, uint32_t instance_id, const uint64_t *values, uint32_t values_nb);
+
     void addKeyedValuesFloat32(const std::string &key, uint32_t instance_id, const std::vector<float> &values);
 
+    void addKeyedValuesFloat32(const std::string &key, uint32_t instance_id, const float *values, uint32_t values_nb);
+
     void addKeyedValuesFloat64(const std::string &key, uint32_t instance_id, const std::vector<double> &values);
 
+    void addKeyedValuesFloat64(const std::string &key, uint32_t instance_id, const double *values, uint32_t values_nb);
+
+    // Typed core of the named methods above, the value type is deduced from T at compile time
+    // (see GBKFCore::KeyedEntry::deduceValueType()), so uint8_t values are UINT8 and not BLOB.
+    // The pointer version accepts the fixed-width types, the vector one also accepts bool and std::string
+    // (written as dynamic strings, see addKeyedValuesStringUTF8() for a max size).
+    template<typename T>
+    void addKeyedValues(const std::string &key, uint32_t instance_id, const T *values, uint32_t values_nb);
+
+    template<typename T>
+    void addKeyedValues(const std::string &key, uint32_t instance_id, const std::vector<T> &values);
+
+    // Adds the records of many instances of the same key at once, with a single allocation of the buffer
+    // (a streaming buffer is flushed between the records when it is full).
+    // The values of instance_ids[i] are values[values_offsets[i]] to values[values_offsets[i + 1]] (excluded),
+    // so values_offsets holds instance_ids_nb + 1 positions. T is any fixed-width type (uint8_t is UINT8).
+    // Throws std::invalid_argument if the offsets decrease, without changing the writer.
+    template<typename T>
+    void addKeyedValuesColumns(const std::string &key,
+                               const uint32_t *instance_ids,
+                               uint32_t instance_ids_nb,
+                               const T *values,
+                               const uint64_t *values_offsets);
+
+    // Also throws std::invalid_argument if the offsets do not match the sizes of the vectors.
+    template<typename T>
+    void addKeyedValuesColumns(const std::string &key,
+                               const std::vector<uint32_t> &instance_ids,
+                               const std::vector<T> &values,
+                               const std::vector<uint64_t> &values_offsets);
+
+    // write(), getBytesBuffer() and takeBytesBuffer() keep the hash of the data between calls: if the header
+    // did not change since the previous call, only the keyed-values added since then are hashed.
+    // (e.g. set the keyed-values number up-front and use auto_update=false for periodic checkpoints).
     void write(const std::string &write_path, bool auto_update = true, bool add_footer = true);
 
     std::vector<uint8_t> getBytesBuffer(bool auto_update = true, bool add_footer = true);
 
+    // Moves the buffer out of the writer, without copy, and resets the writer.
+    // The index block and the footer are appended in place, without reallocation if reserve() or
+    // reserveRecords() were used.
+    std::vector<uint8_t> takeBytesBuffer(bool auto_update = true, bool add_footer = true);
+
+    [[nodiscard]] bool isStreaming() const;
+
+    // Adds an index of the records before the footer (see GBKFCore::IndexBlock), so the readers can find a
+    // record without scanning the others. It must be set before adding keyed-values, and reset() keeps it.
+    void setIndexBlock(bool enabled = true);
+
+    // Compresses the values of the records added next (see GBKFCore::CompressedValues), in chunks of chunk_size
+    // bytes that the readers can decompress in parallel. A record stays uncompressed when it would not be smaller,
+    // and the records of addKeyedValuesColumns() are never compressed. Compression::NONE stops the compression.
+    // Throws std::invalid_argument if the compression is not available in this build, or for an invalid chunk size.
+    void setCompression(GBKFCore::Compression compression,
+                        int level = 0,
+                        uint32_t chunk_size = GBKFCore::CompressedValues::DEFAULT_CHUNK_SIZE);
+
+    // Counters of this writer. They stay at 0 unless the library is built with GBKF_STATS.
+    [[nodiscard]] GBKFCore::Stats getStats() const;
+
+    void resetStats();
+
+    // Flushes the buffer, patches the header and appends the footer of a streaming writer.
+    void close(bool auto_update = true, bool add_footer = true);
+
+    // Runs close() on another thread. The writer must not be used, moved or destroyed until the future is ready.
+    [[nodiscard]] std::future<void> closeAsync(bool auto_update = true, bool add_footer = true);
+
 private:
     std::vector<uint8_t> m_byte_buffer;
 
+    // Hash of the first m_buffer_sha_size bytes of the buffer, computed with the header m_buffer_sha_header.
+    // The records are only appended, so each footer only hashes the new records if the header did not change.
+    GBKFCore::Sha256 m_buffer_sha;
+    uint64_t m_buffer_sha_size = 0;
+    std::vector<uint8_t> m_buffer_sha_header;
+
     uint8_t m_keys_size;
     uint32_t m_keyed_values_nb;
-    std::vector<std::string> m_keys;
+    std::unordered_set<std::string> m_keys;
+    size_t m_keys_min_length; // Length range of m_keys, to check the keys size without scanning them
+    size_t m_keys_max_length;
+
+    // File, hash and background thread of the streaming mode, on the heap so they stay in place when moving
+    struct Stream;
+
+    std::string m_stream_path;
+    uint64_t m_stream_buffer_size = 0; // 0 when not streaming
+    uint32_t m_stream_async_buffers_nb = 0;
+    std::unique_ptr<Stream> m_stream;
+
+    struct IndexEntry {
+        const std::string *key; // In m_keys
+        uint32_t instance_id;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    bool m_index_block = false;
+    std::vector<IndexEntry> m_index_entries;
+    uint64_t m_buffer_offset = 0; // Position in the file of the buffer, the records already flushed are before it
 
-    static std::string normalizeString(const std::string &input);
+    GBKFCore::Compression m_compression = GBKFCore::Compression::NONE;
+    int m_compression_level = 0;
+    uint32_t m_compression_chunk_size = GBKFCore::CompressedValues::DEFAULT_CHUNK_SIZE;
+    uint64_t m_record_values_pos = 0; // Values of the last record added by writeKeyedValuesHeader()
 
-    static std::vector<uint8_t> formatKey(const std::string &key);
+    // Replaces the values of the last record by their compression, if it is smaller
+    void compressRecord();
 
-    static std::vector<uint8_t> formatUInt16(uint16_t value);
+    // Empty when the index block is not set
+    [[nodiscard]] std::vector<uint8_t> buildIndexBlock(uint64_t index_start) const;
 
-    static std::vector<uint8_t> formatUInt32(uint32_t value);
+    // Footer of the buffer followed by the index block
+    [[nodiscard]] std::vector<uint8_t> digestBuffer(const std::vector<uint8_t> &index_block) const;
+
+    // Null when the library is built without GBKF_STATS, shared with the background thread of the stream
+    std::shared_ptr<GBKFCore::StatsCounters> m_stats;
+
+    void initStats();
+
+    // Returns the input without its trailing nulls
+    static std::string_view normalizeString(std::string_view input);
 
     void setUInt8(uint8_t value, uint64_t start_pos);
 
@@ -94,10 +279,43 @@ private:
 
     void setUInt64(uint64_t value, uint64_t start_pos);
 
-    void writeKeyedValuesHeader(const std::string &key,
+    void openStream();
+
+    // close() of an open stream, ignoring its errors
+    void closeOpenStream() noexcept;
+
+    void reserveBuffer(uint64_t bytes, uint64_t records_nb);
+
+    // Opens the file of openAppend(), positioned after its records
+    void openAppendStream();
+
+    void flushStream();
+
+    // Hashes the buffer up to end_pos, from scratch if the header changed since the last call.
+    void updateBufferSha(uint64_t end_pos);
+
+    void registerKeyedValues(const std::string &key);
+
+    template<typename T>
+    void addKeyedValuesFixedSize(const std::string &key,
                                  uint32_t instance_id,
-                                 uint32_t values_nb,
-                                 GBKFCore::ValueType value_type);
+                                 GBKFCore::ValueType value_type,
+                                 const T *values,
+                                 uint32_t values_nb);
+
+    // Appends the header and values_size bytes filled with zeros, and returns the position of the values.
+    // The position is valid until the next change of the buffer.
+    uint8_t *writeKeyedValuesHeader(const std::string &key,
+                                    uint32_t instance_id,
+                                    uint32_t values_nb,
+                                    GBKFCore::ValueType value_type,
+                                    uint64_t values_size);
+
+    // Appends the header of values_nb booleans, and returns the position of the packed bytes, filled with zeros.
+    uint8_t *writeBooleanHeader(const std::string &key, uint32_t instance_id, uint32_t values_nb);
+
+    // Compresses the record and stores its key, once its values are written.
+    void endKeyedValues(const std::string &key);
 };
 
 #endif // GBKF_CORE_WRITER_HXX
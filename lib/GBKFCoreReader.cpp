@@ -17,47 +17,241 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
-
-#ifdef USE_OPEN_SSL
-    #include <openssl/sha.h>;
-#else
-#include "GBKF/picosha2.hxx"
+#include <future>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <system_error>
+#include <unordered_set>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+    #define GBKF_HAS_MMAP
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
 #endif
 
 #include "GBKF/GBKFCore.hxx"
 #include "GBKF/GBKFCoreReader.hxx"
+#include "GBKF/GBKFCoreSha256.hxx"
+#include "GBKF/GBKFCoreCompression.hxx"
 
 using namespace GBKFCore;
 
-GBKFCoreReader::GBKFCoreReader(const std::vector<uint8_t> &data) {
+namespace {
+    // The decoding is written once for any allocator, the values are appended to the given vector.
+
+    // The data is little-endian, like the host (checked by the constructors), so the values are copied at once.
+    template<typename T, typename Allocator>
+    uint64_t readValuesFixedSize(const uint8_t *data,
+                                 const uint64_t start_pos,
+                                 const uint32_t values_nb,
+                                 std::vector<T, Allocator> &values) {
+        const uint64_t values_bytes = static_cast<uint64_t>(values_nb) * sizeof(T);
+
+        const size_t previous_size = values.size();
+        values.resize(previous_size + values_nb);
+        if (values_bytes > 0) {
+            std::memcpy(values.data() + previous_size, data + start_pos, values_bytes);
+        }
 
+        return start_pos + values_bytes;
+    }
 
-    uint16_t num = 1;
-    if (*reinterpret_cast<uint8_t*>(&num) != 1) {
-        throw std::runtime_error("System is not little-endian. Unsupported platform.");
+    template<typename Allocator>
+    uint64_t readValuesPackedBool(const uint8_t *data,
+                            uint64_t start_pos,
+                            const uint32_t values_nb,
+                            const uint8_t last_byte_bools_nb,
+                            std::vector<bool, Allocator> &values) {
+        // The writers store 0 booleans for the last byte of an empty record
+        if (values_nb == 0) {
+            return start_pos;
+        }
+
+        // The writers store the booleans number of the last byte, from 1 to 8
+        const uint8_t expected_last_byte_bools_nb = values_nb % 8 == 0 ? 8 : values_nb % 8;
+        if (last_byte_bools_nb != expected_last_byte_bools_nb) {
+            throw std::invalid_argument("Boolean reading out of bounds on last byte");
+        }
+
+        // The bits are set in place, without growing the vector for each of them
+        const size_t first_value_nb = values.size();
+        values.resize(first_value_nb + values_nb);
+
+        const uint32_t bytes_nb = values_nb / 8 + (last_byte_bools_nb == 8 ? 0 : 1);
+
+        for (uint32_t i = 0; i < bytes_nb; ++i) {
+            const uint8_t byte = data[start_pos];
+            ++start_pos;
+
+            const uint8_t bits_to_process = (i == bytes_nb - 1) ? last_byte_bools_nb : 8;
+            const size_t byte_value_nb = first_value_nb + static_cast<size_t>(i) * 8;
+            for (uint8_t bit = 0; bit < bits_to_process; ++bit) {
+                values[byte_value_nb + bit] = (byte >> bit) & 1;
+            }
+        }
+
+        return start_pos;
     }
 
+    // Strings of max_size bytes, padded with NUL.
+    // String can be any type constructible from a pointer and a size, like std::string or std::string_view.
+    template<typename String, typename Allocator>
+    uint64_t readValuesString(const uint8_t *data,
+                              uint64_t start_pos,
+                              const uint32_t values_nb,
+                              const uint16_t max_size,
+                              std::vector<String, Allocator> &values) {
+        values.reserve(values.size() + values_nb);
+
+        for (uint32_t i = 0; i < values_nb; ++i) {
+            const auto *start_ptr = reinterpret_cast<const char *>(data + start_pos);
+            values.emplace_back(start_ptr, std::find(start_ptr, start_ptr + max_size, '\0') - start_ptr);
+            start_pos += max_size;
+        }
 
-    m_gbkf_version = 0;
-    m_specification_id = 0;
-    m_specification_version = 0;
-    m_keys_size = 1;
-    m_keyed_values_nb = 0;
+        return start_pos;
+    }
 
-    m_bytes_data = data;
+    // Strings prefixed by their size in bytes (uint16), within the total_bytes that follow start_pos.
+    template<typename String, typename Allocator>
+    uint64_t readValuesText(const uint8_t *data,
+                            uint64_t start_pos,
+                            const uint32_t values_nb,
+                            const uint32_t total_bytes,
+                            std::vector<String, Allocator> &values) {
+        const uint64_t end_pos = start_pos + total_bytes;
+        values.reserve(values.size() + values_nb);
+
+        for (uint32_t i = 0; i < values_nb; ++i) {
+            if (start_pos + 2 > end_pos) {
+                throw std::runtime_error("String values out of bounds");
+            }
 
-    readHeader();
-    readSha();
+            uint16_t string_size;
+            std::memcpy(&string_size, data + start_pos, 2);
+            start_pos += 2;
+
+            if (start_pos + string_size > end_pos) {
+                throw std::runtime_error("String values out of bounds");
+            }
+
+            const auto *start_ptr = reinterpret_cast<const char *>(data + start_pos);
+            values.emplace_back(start_ptr, std::find(start_ptr, start_ptr + string_size, '\0') - start_ptr);
+            start_pos += string_size;
+        }
+
+        return start_pos;
+    }
+
+    // Decodes the values of a STRING record, after checking its type.
+    template<typename String, typename Allocator>
+    uint64_t readRecordStrings(const uint8_t *data, const KeyedRecord &record, std::vector<String, Allocator> &values) {
+        if (record.type != ValueType::STRING) {
+            throw std::runtime_error("Type mismatch on string values");
+        }
+
+        uint64_t current_pos = record.values_pos;
+
+        uint16_t max_string_size;
+        std::memcpy(&max_string_size, data + current_pos, 2);
+        current_pos += 2;
+
+        if (max_string_size == 0) {
+            // Dynamic strings, stored after the total number of bytes
+            uint32_t total_bytes;
+            std::memcpy(&total_bytes, data + current_pos, 4);
+            current_pos += 4;
+
+            return readValuesText(data, current_pos, record.values_nb, total_bytes, values);
+        }
+
+        return readValuesString(data, current_pos, record.values_nb, max_string_size, values);
+    }
+
+    // Decodes the values of a record of type V, which is checked by the caller (except for strings).
+    template<ValueType V, typename Vector>
+    uint64_t readRecordValues(const uint8_t *data, const KeyedRecord &record, Vector &values) {
+        if constexpr (V == ValueType::STRING) {
+            return readRecordStrings(data, record, values);
+
+        } else if constexpr (V == ValueType::BOOLEAN) {
+            return readValuesPackedBool(data, record.values_pos + 1, record.values_nb, data[record.values_pos], values);
 
+        } else {
+            static_assert(ValueTypeTraits<V>::value_size == sizeof(typename Vector::value_type));
+            return readValuesFixedSize(data, record.values_pos, record.values_nb, values);
+        }
+    }
 }
 
+GBKFCoreReader::GBKFCoreReader(const std::vector<uint8_t> &data, const ShaVerification sha_verification) {
+    auto owned_data = std::make_shared<const std::vector<uint8_t> >(data);
+    init(owned_data->data(), owned_data->size(), owned_data, sha_verification);
+}
 
-GBKFCoreReader::GBKFCoreReader(const std::string &read_path) {
-    m_gbkf_version = 0;
-    m_specification_id = 0;
-    m_specification_version = 0;
-    m_keys_size = 1;
-    m_keyed_values_nb = 0;
+GBKFCoreReader::GBKFCoreReader(std::vector<uint8_t> &&data, const ShaVerification sha_verification) {
+    auto owned_data = std::make_shared<const std::vector<uint8_t> >(std::move(data));
+    init(owned_data->data(), owned_data->size(), owned_data, sha_verification);
+}
+
+GBKFCoreReader::GBKFCoreReader(const uint8_t *data,
+                               const uint64_t size,
+                               const ShaVerification sha_verification) {
+    // The caller keeps the ownership of the data.
+    init(data, size, nullptr, sha_verification);
+}
+
+GBKFCoreReader::GBKFCoreReader(const std::string &read_path, const ShaVerification sha_verification) {
+    initStats();
+
+#ifdef GBKF_HAS_MMAP
+
+    const int fd = open(read_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file");
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat file");
+    }
+
+    const auto size = static_cast<uint64_t>(file_stat.st_size);
+
+    if (size == 0) {
+        // mmap() does not accept empty mappings, readHeader() will report the error.
+        close(fd);
+        init(nullptr, 0, nullptr, sha_verification);
+        return;
+    }
+
+    void *mapping;
+    {
+        GBKF_STATS_TIMER(m_stats, io_ns);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    // The mapping remains valid after closing the file descriptor.
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file");
+    }
+
+    // The pages are read on access, mostly while hashing
+    GBKF_STATS_ADD(m_stats, bytes_read, size);
+
+    const std::shared_ptr<const void> storage(mapping, [size](const void *ptr) {
+        munmap(const_cast<void *>(ptr), size);
+    });
+
+    init(static_cast<const uint8_t *>(mapping), size, storage, sha_verification);
+
+#else
 
     std::ifstream file(read_path, std::ios::binary);
     if (!file) {
@@ -66,20 +260,264 @@ GBKFCoreReader::GBKFCoreReader(const std::string &read_path) {
 
     file.seekg(0, std::ios::end);
     size_t size = file.tellg();
-    m_bytes_data.resize(size);
+    auto owned_data = std::make_shared<std::vector<uint8_t> >(size);
     file.seekg(0, std::ios::beg);
 
     // std::ifstream::read() only accepts a char* pointer as the destination buffer
     // so reinterpret_cast is used to convert the pointer of the uint8 vector.
     // This works because char and uint8_t are both 1-byte types.
-    file.read(reinterpret_cast<char *>(m_bytes_data.data()), static_cast<std::streamsize>(size));
+    {
+        GBKF_STATS_TIMER(m_stats, io_ns);
+        file.read(reinterpret_cast<char *>(owned_data->data()), static_cast<std::streamsize>(size));
+    }
+    GBKF_STATS_ADD(m_stats, bytes_read, size);
+
+    init(owned_data->data(), owned_data->size(), owned_data, sha_verification);
+
+#endif
+}
+
+void GBKFCoreReader::init(const uint8_t *data,
+                          const uint64_t size,
+                          std::shared_ptr<const void> storage,
+                          const ShaVerification sha_verification) {
+
+    uint16_t num = 1;
+    if (*reinterpret_cast<uint8_t*>(&num) != 1) {
+        throw std::runtime_error("System is not little-endian. Unsupported platform.");
+    }
+
+    m_gbkf_version = 0;
+    m_specification_id = 0;
+    m_specification_version = 0;
+    m_keys_size = 1;
+    m_keyed_values_nb = 0;
+    m_index_entries_pos = 0;
+    m_index_buckets_pos = 0;
+    m_index_buckets_nb = 0;
+
+    initStats();
+
+    m_storage = std::move(storage);
+    m_bytes_data = data;
+    m_bytes_size = size;
 
     readHeader();
-    readSha();
+    readSha(sha_verification);
+    readIndexBlock();
+}
+
+void GBKFCoreReader::initStats() {
+#ifdef GBKF_STATS
+    if (!m_stats) {
+        m_stats = std::make_shared<StatsCounters>();
+    }
+#endif
+}
+
+Stats GBKFCoreReader::getStats() const {
+    return m_stats ? m_stats->snapshot() : Stats();
+}
+
+void GBKFCoreReader::resetStats() {
+    if (m_stats) {
+        m_stats->reset();
+    }
+}
+
+template<typename Entry>
+Entry GBKFCoreReader::decodeKeyedEntry(const KeyedRecord &record,
+                                       const typename Entry::allocator_type &allocator,
+                                       const unsigned int threads_nb) const {
+    GBKF_STATS_TIMER(m_stats, decode_ns);
+    GBKF_STATS_RECORD(m_stats, static_cast<uint8_t>(record.type),
+                      (record.values_nb > 0 ? 1 : 0) + (record.type == ValueType::STRING ? record.values_nb : 0));
+
+    if (record.compressed) {
+        const std::vector<uint8_t> values = decompressValues(m_bytes_data, record, threads_nb);
+        return readKeyedEntry<Entry>(values.data(), decompressedRecord(record, values), allocator);
+    }
+
+    return readKeyedEntry<Entry>(m_bytes_data, record, allocator);
+}
+
+std::vector<uint8_t> GBKFCoreReader::decompressValues(const uint8_t *data,
+                                                      const KeyedRecord &record,
+                                                      unsigned int threads_nb) {
+    // The record bounds already include the header and the compressed size
+    uint64_t current_pos = record.values_pos;
+    uint8_t compression;
+    uint64_t values_size;
+    uint64_t compressed_size;
+    uint32_t chunk_size;
+    uint32_t chunks_nb;
+    std::tie(compression, current_pos) = readUInt8(data, current_pos);
+    std::tie(values_size, current_pos) = readUInt64(data, current_pos);
+    std::tie(compressed_size, current_pos) = readUInt64(data, current_pos);
+    std::tie(chunk_size, current_pos) = readUInt32(data, current_pos);
+    std::tie(chunks_nb, current_pos) = readUInt32(data, current_pos);
+
+    if (chunk_size == 0 || chunk_size > CompressedValues::MAX_CHUNK_SIZE ||
+        chunks_nb != (values_size + chunk_size - 1) / chunk_size ||
+        static_cast<uint64_t>(chunks_nb) * 4 > compressed_size) {
+        throw std::runtime_error("Corrupted compressed values");
+    }
+
+    // Positions of the chunks, from their sizes
+    std::vector<uint64_t> chunks_pos(static_cast<size_t>(chunks_nb) + 1);
+    chunks_pos[0] = current_pos + static_cast<uint64_t>(chunks_nb) * 4;
+    for (uint32_t chunk_nb = 0; chunk_nb < chunks_nb; ++chunk_nb) {
+        chunks_pos[chunk_nb + 1] = chunks_pos[chunk_nb] + readUInt32(data, current_pos + chunk_nb * 4).first;
+    }
+
+    if (chunks_pos[chunks_nb] != current_pos + compressed_size) {
+        throw std::runtime_error("Corrupted compressed values");
+    }
+
+    std::vector<uint8_t> values(values_size);
+    const auto compression_codec = static_cast<Compression>(compression);
+    const uint8_t value_size = Delta::integerValueSize(record.type);
+
+    const auto decompress_chunk = [&](const uint32_t chunk_nb) {
+        const uint64_t values_pos = static_cast<uint64_t>(chunk_nb) * chunk_size;
+        Codecs::decompress(compression_codec,
+                           data + chunks_pos[chunk_nb],
+                           static_cast<uint32_t>(chunks_pos[chunk_nb + 1] - chunks_pos[chunk_nb]),
+                           values.data() + values_pos,
+                           static_cast<uint32_t>(std::min<uint64_t>(chunk_size, values_size - values_pos)),
+                           value_size);
+    };
+
+    if (threads_nb == 0) {
+        threads_nb = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (threads_nb == 1 || chunks_nb < 2) {
+        for (uint32_t chunk_nb = 0; chunk_nb < chunks_nb; ++chunk_nb) {
+            decompress_chunk(chunk_nb);
+        }
+        return values;
+    }
+
+    // The workers take the next chunk until there are none left, the first error is rethrown here
+    std::atomic<uint32_t> next_chunk_nb{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    const auto decompress_chunks = [&]() {
+        for (uint32_t chunk_nb = next_chunk_nb++; chunk_nb < chunks_nb; chunk_nb = next_chunk_nb++) {
+            try {
+                decompress_chunk(chunk_nb);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const uint32_t workers_nb = std::min(threads_nb, chunks_nb);
+    for (uint32_t i = 1; i < workers_nb; ++i) {
+        try {
+            workers.emplace_back(decompress_chunks);
+        } catch (const std::system_error &) {
+            // Continue with the threads already started
+            break;
+        }
+    }
+
+    // The calling thread is also a worker
+    decompress_chunks();
+
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return values;
+}
+
+KeyedRecord GBKFCoreReader::decompressedRecord(const KeyedRecord &record, const std::vector<uint8_t> &values) {
+    KeyedRecord values_record = record;
+    values_record.compressed = false;
+    values_record.values_pos = 0;
+    values_record.end_pos = values.size();
+
+    if (readValuesSize(values.data(), values.size(), values_record) != values.size()) {
+        throw std::runtime_error("Corrupted compressed values");
+    }
+
+    return values_record;
+}
+
+std::vector<std::shared_future<GBKFCoreReader> > GBKFCoreReader::openMany(const std::vector<std::string> &paths,
+                                                                          const ShaVerification sha_verification,
+                                                                          unsigned int threads_nb) {
+    if (threads_nb == 0) {
+        threads_nb = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Shared by the workers, which may outlive the call and the futures
+    struct OpenFiles {
+        std::vector<std::string> paths;
+        std::vector<std::promise<GBKFCoreReader> > readers;
+        std::atomic<size_t> next_path_nb{0};
+    };
+
+    const auto open_files = std::make_shared<OpenFiles>();
+    open_files->paths = paths;
+    open_files->readers.resize(paths.size());
+
+    std::vector<std::shared_future<GBKFCoreReader> > futures;
+    futures.reserve(paths.size());
+    for (auto &reader: open_files->readers) {
+        futures.push_back(reader.get_future().share());
+    }
+
+    // The workers take the next file to open until there are none left
+    const auto open_next_files = [open_files, sha_verification]() {
+        for (size_t path_nb = open_files->next_path_nb++;
+             path_nb < open_files->paths.size();
+             path_nb = open_files->next_path_nb++) {
+            try {
+                open_files->readers[path_nb].set_value(GBKFCoreReader(open_files->paths[path_nb], sha_verification));
+            } catch (...) {
+                open_files->readers[path_nb].set_exception(std::current_exception());
+            }
+        }
+    };
+
+    const size_t workers_nb = std::min<size_t>(threads_nb, paths.size());
+    size_t started_workers_nb = 0;
+    for (; started_workers_nb < workers_nb; ++started_workers_nb) {
+        try {
+            std::thread(open_next_files).detach();
+        } catch (const std::system_error &) {
+            // Continue with the threads already started
+            break;
+        }
+    }
+
+    // Without any thread, the files are opened by the calling thread
+    if (started_workers_nb == 0) {
+        open_next_files();
+    }
+
+    return futures;
 }
 
 bool GBKFCoreReader::verifiesSha() const {
-    return m_sha256_read == m_sha256_calculated && !m_sha256_read.empty();
+    if (m_sha256_read.empty()) {
+        return false;
+    }
+
+    // Waits for (or runs) a deferred or background hash, the result is then cached.
+    return m_sha256_read == m_sha256_calculated.get();
 }
 
 uint8_t GBKFCoreReader::getGBKFVersion() const {
@@ -105,437 +543,642 @@ uint32_t GBKFCoreReader::getKeyedValuesNb() const {
 std::unordered_map<std::string, std::vector<KeyedEntry> > GBKFCoreReader::getKeyedEntries() const {
     std::unordered_map<std::string, std::vector<KeyedEntry> > keyed_entries_mapping;
 
-    uint64_t current_pos = Header::SIZE;
+    for (const KeyedRecord &record: getKeyedRecords()) {
+        KeyedEntry keyed_entry = decodeKeyedEntry(record);
+        GBKF_STATS_TIMER(m_stats, insert_ns);
+        keyed_entries_mapping[std::string(record.key)].push_back(std::move(keyed_entry));
+    }
 
-    for (uint32_t i = 0; i < m_keyed_values_nb; ++i) {
-        auto [key, p1] = readString1Byte(current_pos, m_keys_size);
-        auto [instance_id, p2] = readUInt32(p1);
-        auto [values_type, p3] = readUInt8(p2);
-        auto [values_nb, p4] = readUInt32(p3);
-        current_pos = p4;
+    return keyed_entries_mapping;
+}
 
-        KeyedEntry keyed_entry(static_cast<ValueType>(values_type));
-        keyed_entry.instance_id = instance_id;
+std::unordered_map<std::string, std::vector<KeyedEntry> > GBKFCoreReader::getKeyedEntries(
+    unsigned int threads_nb) const {
 
-        switch (keyed_entry.getType()) {
-            case ValueType::STRING: {
+    if (threads_nb == 0) {
+        threads_nb = std::max(1u, std::thread::hardware_concurrency());
+    }
 
-                // Read the max string size
-                const auto [max_string_size, new_pos] = readUInt16(current_pos);
-                current_pos = new_pos;
+    const KeyedRecordsIndex &index = getIndex();
+    const std::vector<KeyedRecord> &records = index.records;
 
+    if (threads_nb == 1 || records.size() < 2) {
+        return getKeyedEntries();
+    }
 
-                if (max_string_size == 0) {
-                    //
-                    // Dynamic strings
-                    //
+    // Split the records into contiguous ranges of about the same size in bytes
+    const uint64_t records_bytes = records.back().end_pos - Header::SIZE;
+    const uint64_t range_bytes = std::max<uint64_t>(1, records_bytes / threads_nb);
+
+    std::vector<std::pair<size_t, size_t> > ranges;
+    size_t range_start = 0;
+    uint64_t range_start_pos = Header::SIZE;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].end_pos - range_start_pos >= range_bytes || i + 1 == records.size()) {
+            ranges.emplace_back(range_start, i + 1);
+            range_start = i + 1;
+            range_start_pos = records[i].end_pos;
+        }
+    }
 
-                    // Read the total number of bytes
-                    const auto [total_bytes, new_pos1] = readUInt32(current_pos);
-                    current_pos = new_pos1;
+    // Each worker decodes into its own vector, so there is no shared state to lock
+    std::vector<std::future<std::vector<KeyedEntry> > > workers;
+    workers.reserve(ranges.size());
 
-                    std::vector<std::string> values;
-                    std::tie(values, current_pos) = readValuesTextUTF8(current_pos, values_nb);
+    for (const auto &[start, end]: ranges) {
+        workers.push_back(std::async(std::launch::async, [this, &records, start = start, end = end]() {
+            std::vector<KeyedEntry> keyed_entries;
+            keyed_entries.reserve(end - start);
+            for (size_t i = start; i < end; ++i) {
+                keyed_entries.push_back(decodeKeyedEntry(records[i], {}, 1));
+            }
+            return keyed_entries;
+        }));
+    }
 
-                    keyed_entry.addValues(values);
+    // The entries are moved in the records order, the exceptions of the workers are rethrown here
+    std::vector<KeyedEntry> decoded_entries;
+    decoded_entries.reserve(records.size());
+    for (auto &worker: workers) {
+        std::vector<KeyedEntry> keyed_entries = worker.get();
+        std::move(keyed_entries.begin(), keyed_entries.end(), std::back_inserter(decoded_entries));
+    }
 
-                }else {
+    GBKF_STATS_TIMER(m_stats, insert_ns);
+    std::unordered_map<std::string, std::vector<KeyedEntry> > keyed_entries_mapping;
+    keyed_entries_mapping.reserve(index.records_by_key.size());
 
-                    //
-                    // Fixed strings
-                    //
+    for (const auto &[key, records_nb]: index.records_by_key) {
+        std::vector<KeyedEntry> &keyed_entries = keyed_entries_mapping[std::string(key)];
+        keyed_entries.reserve(records_nb.size());
+        for (const uint32_t record_nb: records_nb) {
+            keyed_entries.push_back(std::move(decoded_entries[record_nb]));
+        }
+    }
 
-                    std::vector<std::string> values;
-                    std::tie(values, current_pos) = readValuesStringUTF8(current_pos, values_nb, max_string_size);
+    return keyed_entries_mapping;
+}
 
-                    keyed_entry.addValues(values);
-                }
+pmr::KeyedEntriesMap GBKFCoreReader::getKeyedEntries(std::pmr::memory_resource *resource) const {
+    const KeyedRecordsIndex &index = getIndex();
+    const pmr::KeyedEntry::allocator_type allocator(resource);
 
-                break;
-            }
+    pmr::KeyedEntriesMap keyed_entries_mapping(allocator);
+    keyed_entries_mapping.reserve(index.records_by_key.size());
 
-            case ValueType::BLOB: {
-                auto [values, new_pos] = readValuesBlob(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+    for (const auto &[key, records_nb]: index.records_by_key) {
+        auto &keyed_entries = keyed_entries_mapping[std::pmr::string(key, allocator)];
+        keyed_entries.reserve(records_nb.size());
+        for (const uint32_t record_nb: records_nb) {
+            keyed_entries.push_back(decodeKeyedEntry<pmr::KeyedEntry>(index.records[record_nb], allocator));
+        }
+    }
 
-            case ValueType::BOOLEAN: {
-                auto [last_byte_bools_nb, pos1] = readUInt8(current_pos);
-                auto [values, pos2] = readValuesBool(pos1, values_nb, last_byte_bools_nb);
-                keyed_entry.addValues(values);
-                current_pos = pos2;
-                break;
-            }
+    return keyed_entries_mapping;
+}
 
-            case ValueType::INT8: {
-                auto [values, new_pos] = readValuesInt8(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+std::unordered_map<std::string, std::vector<KeyedEntry> > GBKFCoreReader::getKeyedEntries(
+    const KeyedEntriesFilter &filter) const {
 
-            case ValueType::INT16: {
-                auto [values, new_pos] = readValuesInt16(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+    const std::unordered_set<std::string_view> keys(filter.keys.begin(), filter.keys.end());
 
-            case ValueType::INT32: {
-                auto [values, new_pos] = readValuesInt32(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+    // The key is checked by the caller when the records are looked up by key
+    const auto matches = [&filter](const KeyedRecord &record) {
+        const auto type_nb = static_cast<uint8_t>(record.type);
+        return type_nb < 64 && (filter.types_mask & KeyedEntriesFilter::typeMask(record.type)) != 0 &&
+               record.instance_id >= filter.instance_id_min && record.instance_id <= filter.instance_id_max &&
+               (!filter.key_predicate || filter.key_predicate(record.key));
+    };
 
-            case ValueType::INT64: {
-                auto [values, new_pos] = readValuesInt64(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
+    std::unordered_map<std::string, std::vector<KeyedEntry> > keyed_entries_mapping;
+    const auto add_entry = [this, &keyed_entries_mapping](const KeyedRecord &record) {
+        KeyedEntry keyed_entry = decodeKeyedEntry(record);
+        GBKF_STATS_TIMER(m_stats, insert_ns);
+        keyed_entries_mapping[std::string(record.key)].push_back(std::move(keyed_entry));
+    };
+
+    if (const auto index = std::atomic_load(&m_index)) {
+        if (!keys.empty()) {
+            for (const std::string_view key: keys) {
+                const auto found = index->records_by_key.find(key);
+                if (found == index->records_by_key.end()) {
+                    continue;
+                }
+                for (const uint32_t record_nb: found->second) {
+                    if (matches(index->records[record_nb])) {
+                        add_entry(index->records[record_nb]);
+                    }
+                }
             }
-
-            case ValueType::UINT8: {
-                auto [values, new_pos] = readValuesUInt8(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
+        } else {
+            for (const KeyedRecord &record: index->records) {
+                if (matches(record)) {
+                    add_entry(record);
+                }
             }
+        }
+        return keyed_entries_mapping;
+    }
 
-            case ValueType::UINT16: {
-                auto [values, new_pos] = readValuesUInt16(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+    // Jump from record to record with the size of their values
+    uint64_t current_pos = Header::SIZE;
+    for (uint32_t i = 0; i < m_keyed_values_nb; ++i) {
+        KeyedRecord record;
+        {
+            GBKF_STATS_TIMER(m_stats, scan_ns);
+            record = readKeyedRecord(current_pos);
+        }
+        current_pos = record.end_pos;
 
-            case ValueType::UINT32: {
-                auto [values, new_pos] = readValuesUInt32(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+        if ((keys.empty() || keys.count(record.key) > 0) && matches(record)) {
+            add_entry(record);
+        }
+    }
 
-            case ValueType::UINT64: {
-                auto [values, new_pos] = readValuesUInt64(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+    return keyed_entries_mapping;
+}
 
-            case ValueType::FLOAT32: {
-                auto [values, new_pos] = readValuesFloat32(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+template<ValueType V>
+std::vector<ValueTypeOf<V> > GBKFCoreReader::readValues(const std::string &key, const uint32_t instance_id) const {
+    const std::optional<KeyedRecord> record = findKeyedRecord(key, instance_id);
+    if (!record) {
+        throw std::out_of_range("Keyed entry not found");
+    }
 
-            case ValueType::FLOAT64: {
-                auto [values, new_pos] = readValuesFloat64(current_pos, values_nb);
-                keyed_entry.addValues(values);
-                current_pos = new_pos;
-                break;
-            }
+    if (record->type != V) {
+        throw std::runtime_error("Type mismatch on values");
+    }
 
-            default: {
-                throw std::runtime_error("Unsupported value type");
-            };
-        }
+    GBKF_STATS_TIMER(m_stats, decode_ns);
+    GBKF_STATS_RECORD(m_stats, static_cast<uint8_t>(V), record->values_nb > 0 ? 1 : 0);
 
-        if (keyed_entries_mapping.find(key) != keyed_entries_mapping.end()) {
-            keyed_entries_mapping[key].push_back(keyed_entry);
-        } else {
-            const std::vector<KeyedEntry> new_key_data = {keyed_entry};
-            keyed_entries_mapping[key] = new_key_data;
-        }
+    std::vector<ValueTypeOf<V> > values;
+    if (record->compressed) {
+        const std::vector<uint8_t> record_values = decompressValues(m_bytes_data, *record);
+        readRecordValues<V>(record_values.data(), decompressedRecord(*record, record_values), values);
+    } else {
+        readRecordValues<V>(m_bytes_data, *record, values);
     }
-    return keyed_entries_mapping;
+    return values;
 }
 
-void GBKFCoreReader::readSha() {
-
-    if (m_bytes_data.size() < Header::SIZE + FOOTER_SIZE) {
-        return;
+#define GBKF_INSTANTIATE_READ_VALUES(V) \
+    template std::vector<ValueTypeOf<V> > GBKFCoreReader::readValues<V>(const std::string &, uint32_t) const;
+
+GBKF_INSTANTIATE_READ_VALUES(ValueType::BLOB)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::BOOLEAN)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::STRING)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::INT8)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::INT16)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::INT32)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::INT64)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::UINT8)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::UINT16)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::UINT32)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::UINT64)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::FLOAT32)
+GBKF_INSTANTIATE_READ_VALUES(ValueType::FLOAT64)
+
+#undef GBKF_INSTANTIATE_READ_VALUES
+
+std::vector<std::string_view> GBKFCoreReader::getStringViews(const std::string &key, const uint32_t instance_id) const {
+    const std::optional<KeyedRecord> record = findKeyedRecord(key, instance_id);
+    if (!record) {
+        throw std::out_of_range("Keyed entry not found");
     }
+    if (record->compressed) {
+        throw std::runtime_error("Compressed values have no view");
+    }
+    return readStringViews(m_bytes_data, *record);
+}
 
-#ifdef USE_OPEN_SSL
-    m_sha256_read.assign(m_bytes_data.end() - FOOTER_SIZE, m_bytes_data.end());
-    m_sha256_calculated.resize(FOOTER_SIZE);
-    SHA256(m_bytes_data.data(), m_bytes_data.size() - FOOTER_SIZE, m_sha256_calculated.data());
+BitmapView GBKFCoreReader::getBitmapView(const std::string &key, const uint32_t instance_id) const {
+    const std::optional<KeyedRecord> record = findKeyedRecord(key, instance_id);
+    if (!record) {
+        throw std::out_of_range("Keyed entry not found");
+    }
+    if (record->type != ValueType::BOOLEAN) {
+        throw std::runtime_error("Type mismatch on bitmap view");
+    }
+    if (record->compressed) {
+        throw std::runtime_error("Compressed values have no view");
+    }
 
-#else
-    m_sha256_read.assign(m_bytes_data.end() - FOOTER_SIZE, m_bytes_data.end());
-    m_sha256_calculated.resize(FOOTER_SIZE);
-    picosha2::hash256(m_bytes_data.begin(), m_bytes_data.end() - FOOTER_SIZE, m_sha256_calculated.begin(),
-                      m_sha256_calculated.end());
+    // The packed bytes are after the number of booleans of the last byte
+    return {m_bytes_data + record->values_pos + 1, record->values_nb};
+}
 
-#endif
+const std::vector<KeyedRecord> &GBKFCoreReader::getKeyedRecords() const {
+    return getIndex().records;
 }
 
-void GBKFCoreReader::readHeader() {
+std::vector<KeyedEntry> GBKFCoreReader::findEntries(const std::string &key) const {
+    std::vector<KeyedEntry> keyed_entries;
 
-    if (m_bytes_data.size() < Header::SIZE) {
-        throw std::runtime_error("Header too short");
-    }
+    const KeyedRecordsIndex &index = getIndex();
+    const auto found = index.records_by_key.find(key);
 
-    if (memcmp(m_bytes_data.data(), Header::GBKF_KEYWORD, Header::GBKF_KEYWORD_SIZE) != 0) {
-        throw std::invalid_argument("Invalid start keyword");
+    if (found != index.records_by_key.end()) {
+        keyed_entries.reserve(found->second.size());
+        for (const uint32_t record_nb: found->second) {
+            keyed_entries.push_back(decodeKeyedEntry(index.records[record_nb]));
+        }
     }
 
-    m_gbkf_version = readUInt8(Header::GBKF_VERSION_START).first;
-    m_specification_id = readUInt32(Header::SPECIFICATION_ID_START).first;
-    m_specification_version = readUInt16(Header::SPECIFICATION_VERSION_START).first;
-    m_keys_size = readUInt8(Header::KEYS_SIZE_START).first;
-    m_keyed_values_nb = readUInt32(Header::KEYED_VALUES_NB_START).first;
+    return keyed_entries;
 }
 
-std::pair<std::string, uint64_t> GBKFCoreReader::readString1Byte(const uint64_t start_pos,
-                                                                 const uint16_t max_size) const {
-    const uint8_t *start_ptr = m_bytes_data.data() + start_pos;
-    const uint8_t *end_ptr = start_ptr + max_size;
+bool GBKFCoreReader::hasKeyedEntry(const std::string &key, const uint32_t instance_id) const {
+    return findKeyedRecord(key, instance_id).has_value();
+}
 
-    const uint8_t *null_pos = std::find(start_ptr, end_ptr, '\0');
+KeyedEntry GBKFCoreReader::getKeyedEntry(const std::string &key, const uint32_t instance_id) const {
+    const std::optional<KeyedRecord> record = findKeyedRecord(key, instance_id);
+    if (!record) {
+        throw std::out_of_range("Keyed entry not found");
+    }
+    return decodeKeyedEntry(*record);
+}
 
-    std::string value(reinterpret_cast<const char *>(start_ptr),
-                      reinterpret_cast<const char *>(null_pos));
+const GBKFCoreReader::KeyedRecordsIndex &GBKFCoreReader::getIndex() const {
 
-    return {value, start_pos + max_size};
-}
+    // The index is built once and shared across threads and copies of the reader.
+    // Concurrent first calls may scan the records twice, but only one index is kept.
+    if (const auto index = std::atomic_load(&m_index)) {
+        return *index;
+    }
 
-std::pair<std::string, uint64_t>
-GBKFCoreReader::readStringUTF8(const uint64_t start_pos, const uint16_t max_size) const {
-    const auto end_pos = start_pos + max_size;
+    GBKF_STATS_TIMER(m_stats, scan_ns);
 
-    const uint8_t *start_ptr = m_bytes_data.data() + start_pos;
-    const uint8_t *null_pos = std::find(start_ptr, m_bytes_data.data() + end_pos, '\0');
+    auto index = std::make_shared<KeyedRecordsIndex>();
+    index->records.reserve(m_keyed_values_nb);
 
-    std::string string(
-        reinterpret_cast<const char *>(start_ptr),
-        reinterpret_cast<const char *>(null_pos)
-    );
+    uint64_t current_pos = Header::SIZE;
+    for (uint32_t i = 0; i < m_keyed_values_nb; ++i) {
+        KeyedRecord record = readKeyedRecord(current_pos);
+        current_pos = record.end_pos;
 
-    return {string, end_pos};
-}
+        index->records_by_key[record.key].push_back(i);
+        index->records.push_back(record);
+    }
 
-std::pair<uint8_t, uint64_t> GBKFCoreReader::readUInt8(const uint64_t start_pos) const {
-    return {m_bytes_data[start_pos], start_pos + 1};
+    std::shared_ptr<const KeyedRecordsIndex> expected;
+    std::shared_ptr<const KeyedRecordsIndex> desired = std::move(index);
+    if (!std::atomic_compare_exchange_strong(&m_index, &expected, desired)) {
+        return *expected;
+    }
+    return *desired;
 }
 
-std::pair<uint16_t, uint64_t> GBKFCoreReader::readUInt16(const uint64_t start_pos) const {
-    const auto* ptr = reinterpret_cast<const uint16_t*>(&m_bytes_data[start_pos]);
-    return {*ptr, start_pos + 2};
+std::string_view GBKFCoreReader::normalizeKey(const std::string_view key) const {
+    // Like the keys of the records, up to the first null
+    return key.substr(0, std::min<size_t>(key.find('\0'), m_keys_size));
 }
 
-std::pair<uint32_t, uint64_t> GBKFCoreReader::readUInt32(const uint64_t start_pos) const {
-    const auto* ptr = reinterpret_cast<const uint32_t*>(&m_bytes_data[start_pos]);
-    return {*ptr, start_pos + 4};
-}
+std::optional<KeyedRecord> GBKFCoreReader::findKeyedRecord(const std::string &key, const uint32_t instance_id) const {
+    const std::string_view normalized_key = normalizeKey(key);
 
-std::pair<uint64_t, uint64_t> GBKFCoreReader::readUInt64(const uint64_t start_pos) const {
-    const auto* ptr = reinterpret_cast<const uint64_t*>(&m_bytes_data[start_pos]);
-    return {*ptr, start_pos + 8};
-}
+    // The index block avoids scanning the records, unless they are already cached
+    if (m_index_buckets_nb > 0 && !std::atomic_load(&m_index)) {
+        return findIndexedRecord(normalized_key, instance_id);
+    }
 
-std::pair<float, uint64_t> GBKFCoreReader::readFloat32(const uint64_t start_pos) const {
-    float value;
-    std::memcpy(&value, m_bytes_data.data() + start_pos, 4);
-    return {value, start_pos + 4};
-}
+    const KeyedRecordsIndex &index = getIndex();
+    const auto found = index.records_by_key.find(normalized_key);
 
-std::pair<double, uint64_t> GBKFCoreReader::readFloat64(const uint64_t start_pos) const {
-    double value;
-    std::memcpy(&value, m_bytes_data.data() + start_pos, 8);
-    return {value, start_pos + 8};
+    if (found != index.records_by_key.end()) {
+        for (const uint32_t record_nb: found->second) {
+            if (index.records[record_nb].instance_id == instance_id) {
+                return index.records[record_nb];
+            }
+        }
+    }
+
+    return std::nullopt;
 }
 
-std::pair<std::vector<uint8_t>, uint64_t> GBKFCoreReader::readValuesBlob(const uint64_t start_pos,
-                                                                         const uint32_t values_nb) const {
+std::optional<KeyedRecord> GBKFCoreReader::findIndexedRecord(const std::string_view key,
+                                                             const uint32_t instance_id) const {
+
+    const uint64_t entry_size = m_keys_size + IndexBlock::ENTRY_SIZE_WITHOUT_KEY;
+    const uint32_t buckets_mask = m_index_buckets_nb - 1;
 
-    const auto it_start = std::next(m_bytes_data.cbegin(), static_cast<ptrdiff_t>(start_pos));
-    const auto it_end   = std::next(it_start, static_cast<ptrdiff_t>(values_nb));
+    // The writer keeps half of the buckets empty, so the probing ends
+    uint32_t bucket_nb = static_cast<uint32_t>(IndexBlock::hash(key, instance_id)) & buckets_mask;
+    for (uint32_t probe_nb = 0; probe_nb < m_index_buckets_nb; ++probe_nb) {
+        const uint64_t bucket_pos = m_index_buckets_pos + static_cast<uint64_t>(bucket_nb) * IndexBlock::BUCKET_SIZE;
+        const uint32_t entry_nb = readUInt32(m_bytes_data, bucket_pos).first;
+        if (entry_nb == 0) {
+            break;
+        }
+        if (entry_nb > m_keyed_values_nb) {
+            throw std::runtime_error("Index block entry out of bounds");
+        }
+
+        const uint64_t entry_pos = m_index_entries_pos + (entry_nb - 1) * entry_size;
+        const auto *entry_key_ptr = reinterpret_cast<const char *>(m_bytes_data + entry_pos);
+        const auto *entry_key_end = std::find(entry_key_ptr, entry_key_ptr + m_keys_size, '\0');
+
+        if (std::string_view(entry_key_ptr, entry_key_end - entry_key_ptr) == key &&
+            readUInt32(m_bytes_data, entry_pos + m_keys_size).first == instance_id) {
+
+            const uint64_t offset = readUInt64(m_bytes_data, entry_pos + m_keys_size + 4).first;
+            const uint64_t length = readUInt64(m_bytes_data, entry_pos + m_keys_size + 4 + 8).first;
 
-    std::vector<uint8_t> blob(it_start, it_end);
+            // The records are before the index block
+            if (offset < Header::SIZE || offset >= m_index_entries_pos || length > m_index_entries_pos - offset) {
+                throw std::runtime_error("Index block entry out of bounds");
+            }
 
-    return {blob, start_pos + values_nb};
+            KeyedRecord record = readKeyedRecord(offset);
+            if (record.key != key || record.instance_id != instance_id || record.end_pos != offset + length) {
+                throw std::runtime_error("Index block mismatch with the records");
+            }
+            return record;
+        }
+
+        bucket_nb = (bucket_nb + 1) & buckets_mask;
+    }
+
+    return std::nullopt;
 }
 
-std::pair<std::vector<bool>, uint64_t> GBKFCoreReader::readValuesBool(uint64_t start_pos,
-                                                                      const uint32_t values_nb,
-                                                                      const uint8_t last_byte_bools_nb) const {
-    if (last_byte_bools_nb < 1 || last_byte_bools_nb > 8) {
-        throw std::invalid_argument("Boolean reading out of bounds on last byte");
+KeyedRecord GBKFCoreReader::readKeyedRecord(const uint64_t start_pos) const {
+
+    if (start_pos + m_keys_size + KEYED_VALUES_HEADER_SIZE > m_bytes_size) {
+        throw std::runtime_error("Keyed values header out of bounds");
     }
 
-    std::vector<bool> values;
-    values.reserve(values_nb);
+    KeyedRecord record;
 
-    const uint32_t bytes_nb = values_nb / 8 + (last_byte_bools_nb == 8 ? 0 : 1);
+    const auto *key_ptr = reinterpret_cast<const char *>(m_bytes_data + start_pos);
+    const auto *key_end = std::find(key_ptr, key_ptr + m_keys_size, '\0');
+    record.key = std::string_view(key_ptr, key_end - key_ptr);
 
-    for (uint32_t i = 0; i < bytes_nb; ++i) {
-        auto [byte, new_pos] = readUInt8(start_pos);
-        start_pos = new_pos;
+    uint8_t values_type;
+    uint64_t current_pos = start_pos + m_keys_size;
+    std::tie(record.instance_id, current_pos) = readUInt32(m_bytes_data, current_pos);
+    std::tie(values_type, current_pos) = readUInt8(m_bytes_data, current_pos);
+    std::tie(record.values_nb, current_pos) = readUInt32(m_bytes_data, current_pos);
 
-        const uint8_t bits_to_process = (i == bytes_nb - 1) ? last_byte_bools_nb : 8;
-        for (uint8_t bit = 0; bit < bits_to_process; ++bit) {
-            values.push_back((byte >> bit) & 1);
-        }
+    record.compressed = (values_type & CompressedValues::TYPE_FLAG) != 0;
+    record.type = static_cast<ValueType>(values_type & ~CompressedValues::TYPE_FLAG);
+    record.values_pos = current_pos;
+
+    // Compute the size of the values, so the record can be skipped without decoding them.
+    record.end_pos = record.values_pos + readValuesSize(m_bytes_data, m_bytes_size, record);
+
+    if (record.end_pos > m_bytes_size) {
+        throw std::runtime_error("Keyed values out of bounds");
     }
 
-    return {values, start_pos};
+    return record;
 }
 
-std::pair<std::vector<std::string>, uint64_t> GBKFCoreReader::readValuesString1Byte(
-    uint64_t start_pos,
-    const uint32_t values_nb,
-    const uint16_t max_size) const {
-    std::vector<std::string> values(values_nb);
+uint64_t GBKFCoreReader::readValuesSize(const uint8_t *data, const uint64_t size, const KeyedRecord &record) {
+    uint64_t values_size;
 
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], start_pos) = readString1Byte(start_pos, max_size);
+    if (record.compressed) {
+        if (record.values_pos + CompressedValues::HEADER_SIZE > size) {
+            throw std::runtime_error("Keyed values out of bounds");
+        }
+
+        // The compressed size is after the compression and the values size
+        const uint64_t compressed_size = readUInt64(data, record.values_pos + 1 + 8).first;
+        if (compressed_size > UINT64_MAX - record.values_pos - CompressedValues::HEADER_SIZE) {
+            throw std::runtime_error("Keyed values out of bounds");
+        }
+        return CompressedValues::HEADER_SIZE + compressed_size;
     }
-    return {values, start_pos};
-}
 
-std::pair<std::vector<std::string>, uint64_t> GBKFCoreReader::readValuesStringUTF8(
-    uint64_t start_pos,
-    const uint32_t values_nb,
-    const uint16_t max_size) const {
-    std::vector<std::string> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [string, new_pos] = readStringUTF8(start_pos, max_size);
-        values[i] = string;
-        start_pos = new_pos;
+    switch (record.type) {
+        case ValueType::STRING: {
+            if (record.values_pos + 2 > size) {
+                throw std::runtime_error("Keyed values out of bounds");
+            }
+
+            const auto [max_string_size, new_pos] = readUInt16(data, record.values_pos);
+
+            if (max_string_size == 0) {
+                // Dynamic strings: the total number of bytes is stored after the max string size
+                if (new_pos + 4 > size) {
+                    throw std::runtime_error("Keyed values out of bounds");
+                }
+                values_size = 2 + 4 + static_cast<uint64_t>(readUInt32(data, new_pos).first);
+            } else {
+                values_size = 2 + static_cast<uint64_t>(max_string_size) * record.values_nb;
+            }
+            break;
+        }
+
+        case ValueType::BOOLEAN:
+            values_size = 1 + (static_cast<uint64_t>(record.values_nb) + 7) / 8;
+            break;
+
+        case ValueType::BLOB:
+        case ValueType::INT8:
+        case ValueType::UINT8:
+            values_size = record.values_nb;
+            break;
+
+        case ValueType::INT16:
+        case ValueType::UINT16:
+            values_size = static_cast<uint64_t>(record.values_nb) * 2;
+            break;
+
+        case ValueType::INT32:
+        case ValueType::UINT32:
+        case ValueType::FLOAT32:
+            values_size = static_cast<uint64_t>(record.values_nb) * 4;
+            break;
+
+        case ValueType::INT64:
+        case ValueType::UINT64:
+        case ValueType::FLOAT64:
+            values_size = static_cast<uint64_t>(record.values_nb) * 8;
+            break;
+
+        default:
+            throw std::runtime_error("Unsupported value type");
     }
-    return {values, start_pos};
+
+    return values_size;
 }
 
-std::pair<std::vector<std::string>, uint64_t> GBKFCoreReader::readValuesText1Byte(
-    const uint64_t start_pos,
-    const uint32_t values_nb) const {
-    std::vector<std::string> values(values_nb);
+std::vector<std::string_view> GBKFCoreReader::readStringViews(const uint8_t *data, const KeyedRecord &record) {
+    std::vector<std::string_view> values;
+    readRecordStrings(data, record, values);
+    return values;
+}
 
-    uint64_t final_pos = start_pos;
+template<typename Entry>
+Entry GBKFCoreReader::readKeyedEntry(const uint8_t *data,
+                                     const KeyedRecord &record,
+                                     const typename Entry::allocator_type &allocator) {
 
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [string_size, new_pos] = readUInt16(final_pos);
-        std::tie(values[i], final_pos) = readString1Byte(new_pos, string_size);
-    }
-    return {values, final_pos};
+    Entry keyed_entry(record.type, allocator);
+    keyed_entry.instance_id = record.instance_id;
+
+    visitValueType(record.type, [&](auto value_type) {
+        constexpr ValueType V = decltype(value_type)::value;
+        using T = std::conditional_t<V == ValueType::STRING, typename Entry::String, ValueTypeOf<V> >;
+
+        readRecordValues<V>(data, record, keyed_entry.template getValues<T>());
+    });
+
+    return keyed_entry;
 }
 
-std::pair<std::vector<std::string>, uint64_t> GBKFCoreReader::readValuesTextUTF8(
-    const uint64_t start_pos,
-    const uint32_t values_nb) const {
-    std::vector<std::string> values(values_nb);
+template KeyedEntry GBKFCoreReader::readKeyedEntry<KeyedEntry>(const uint8_t *data,
+                                                               const KeyedRecord &record,
+                                                               const KeyedEntry::allocator_type &allocator);
 
-    uint64_t final_pos = start_pos;
+template pmr::KeyedEntry GBKFCoreReader::readKeyedEntry<pmr::KeyedEntry>(
+    const uint8_t *data,
+    const KeyedRecord &record,
+    const pmr::KeyedEntry::allocator_type &allocator);
 
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [string_size, new_pos] = readUInt16(final_pos);
-        std::tie(values[i], final_pos) = readStringUTF8(new_pos, string_size);
+void GBKFCoreReader::readSha(const ShaVerification sha_verification) {
+
+    if (m_bytes_size < Header::SIZE + FOOTER_SIZE) {
+        return;
     }
-    return {values, final_pos};
-}
 
-std::pair<std::vector<int8_t>, uint64_t> GBKFCoreReader::readValuesInt8(
-    uint64_t start_pos,
-    const uint32_t values_nb) const {
-    std::vector<int8_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [value, new_pos] = readUInt8(start_pos);
-        values[i] = static_cast<int8_t>(value);
-        start_pos = new_pos;
+    const uint8_t *bytes_end = m_bytes_data + m_bytes_size;
+    m_sha256_read.assign(bytes_end - FOOTER_SIZE, bytes_end);
+
+    // The storage is captured to keep the data alive while the hash is pending.
+    auto calculate_sha = [storage = m_storage,
+                          stats = m_stats,
+                          data = m_bytes_data,
+                          size = m_bytes_size - FOOTER_SIZE]() {
+        GBKF_STATS_TIMER(stats, hash_ns);
+        return Sha256::hash(data, size);
+    };
+
+    switch (sha_verification) {
+        case ShaVerification::IMMEDIATE: {
+            std::promise<std::vector<uint8_t> > promise;
+            promise.set_value(calculate_sha());
+            m_sha256_calculated = promise.get_future().share();
+            break;
+        }
+
+        case ShaVerification::DEFERRED:
+            m_sha256_calculated = std::async(std::launch::deferred, calculate_sha).share();
+            break;
+
+        case ShaVerification::BACKGROUND:
+            m_sha256_calculated = std::async(std::launch::async, calculate_sha).share();
+            break;
+
+        default:
+            throw std::invalid_argument("Unsupported SHA verification mode");
     }
-    return {values, start_pos};
 }
 
-std::pair<std::vector<int16_t>, uint64_t> GBKFCoreReader::readValuesInt16(
-    uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<int16_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [value, new_pos] = readUInt16(start_pos);
-        values[i] = static_cast<int16_t>(value);
-        start_pos = new_pos;
+void GBKFCoreReader::readIndexBlock() {
+
+    // The block is before the footer, or at the end of the data when it was written without footer
+    if (m_bytes_size >= Header::SIZE + FOOTER_SIZE + IndexBlock::TRAILER_SIZE &&
+        readIndexBlockAt(m_bytes_size - FOOTER_SIZE - IndexBlock::TRAILER_SIZE)) {
+        return;
     }
-    return {values, start_pos};
-}
 
-std::pair<std::vector<int32_t>, uint64_t> GBKFCoreReader::readValuesInt32(
-    uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<int32_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [value, new_pos] = readUInt32(start_pos);
-        values[i] = static_cast<int32_t>(value);
-        start_pos = new_pos;
+    if (m_bytes_size >= Header::SIZE + IndexBlock::TRAILER_SIZE) {
+        (void) readIndexBlockAt(m_bytes_size - IndexBlock::TRAILER_SIZE);
     }
-    return {values, start_pos};
 }
 
-std::pair<std::vector<int64_t>, uint64_t> GBKFCoreReader::readValuesInt64(
-    uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<int64_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        auto [value, new_pos] = readUInt64(start_pos);
-        values[i] = static_cast<int64_t>(value);
-        start_pos = new_pos;
+bool GBKFCoreReader::readIndexBlockAt(const uint64_t trailer_pos) {
+    const uint8_t *trailer = m_bytes_data + trailer_pos;
+
+    if (std::memcmp(trailer + IndexBlock::TRAILER_SIZE - IndexBlock::KEYWORD_SIZE,
+                    IndexBlock::KEYWORD,
+                    IndexBlock::KEYWORD_SIZE) != 0) {
+        return false;
     }
-    return {values, start_pos};
-}
 
-std::pair<std::vector<uint8_t>, uint64_t> GBKFCoreReader::readValuesUInt8(
-    uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<uint8_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], start_pos) = readUInt8(start_pos);
+    uint64_t current_pos = trailer_pos;
+    uint64_t index_start;
+    uint32_t entries_nb;
+    uint32_t buckets_nb;
+    uint8_t version;
+    std::tie(index_start, current_pos) = readUInt64(m_bytes_data, current_pos);
+    std::tie(entries_nb, current_pos) = readUInt32(m_bytes_data, current_pos);
+    std::tie(buckets_nb, current_pos) = readUInt32(m_bytes_data, current_pos);
+    std::tie(version, current_pos) = readUInt8(m_bytes_data, current_pos);
+
+    // Unknown versions and inconsistent blocks are ignored, the records are then scanned
+    if (version != IndexBlock::VERSION ||
+        entries_nb != m_keyed_values_nb ||
+        (buckets_nb & (buckets_nb - 1)) != 0 ||
+        buckets_nb < static_cast<uint64_t>(entries_nb) + 1 ||
+        index_start < Header::SIZE ||
+        index_start > trailer_pos) {
+        return false;
     }
-    return {values, start_pos};
-}
 
-std::pair<std::vector<uint16_t>, uint64_t>
-GBKFCoreReader::readValuesUInt16(uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<uint16_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], start_pos) = readUInt16(start_pos);
+    const uint64_t entry_size = m_keys_size + IndexBlock::ENTRY_SIZE_WITHOUT_KEY;
+    const uint64_t entries_size = static_cast<uint64_t>(entries_nb) * entry_size;
+    if (index_start + entries_size + static_cast<uint64_t>(buckets_nb) * IndexBlock::BUCKET_SIZE != trailer_pos) {
+        return false;
     }
-    return {values, start_pos};
+
+    m_index_entries_pos = index_start;
+    m_index_buckets_pos = index_start + entries_size;
+    m_index_buckets_nb = buckets_nb;
+    return true;
 }
 
-std::pair<std::vector<uint32_t>, uint64_t>
-GBKFCoreReader::readValuesUInt32(uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<uint32_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], start_pos) = readUInt32(start_pos);
-    }
-    return {values, start_pos};
+bool GBKFCoreReader::hasIndexBlock() const {
+    return m_index_buckets_nb > 0;
 }
 
-std::pair<std::vector<uint64_t>, uint64_t>
-GBKFCoreReader::readValuesUInt64(uint64_t start_pos, const uint32_t values_nb) const {
-    std::vector<uint64_t> values(values_nb);
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], start_pos) = readUInt64(start_pos);
+void GBKFCoreReader::readHeader() {
+
+    if (m_bytes_size < Header::SIZE) {
+        throw std::runtime_error("Header too short");
     }
-    return {values, start_pos};
-}
 
-std::pair<std::vector<float>, uint64_t> GBKFCoreReader::readValuesFloat32(const uint64_t start_pos,
-                                                                          const uint32_t values_nb) const {
-    std::vector<float> values(values_nb);
-    uint64_t pos = start_pos;
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], pos) = readFloat32(pos);
+    if (memcmp(m_bytes_data, Header::GBKF_KEYWORD, Header::GBKF_KEYWORD_SIZE) != 0) {
+        throw std::invalid_argument("Invalid start keyword");
     }
-    return {values, pos};
+
+    m_gbkf_version = readUInt8(m_bytes_data, Header::GBKF_VERSION_START).first;
+    m_specification_id = readUInt32(m_bytes_data, Header::SPECIFICATION_ID_START).first;
+    m_specification_version = readUInt16(m_bytes_data, Header::SPECIFICATION_VERSION_START).first;
+    m_keys_size = readUInt8(m_bytes_data, Header::KEYS_SIZE_START).first;
+    m_keyed_values_nb = readUInt32(m_bytes_data, Header::KEYED_VALUES_NB_START).first;
 }
 
-std::pair<std::vector<double>, uint64_t> GBKFCoreReader::readValuesFloat64(const uint64_t start_pos,
-                                                                           const uint32_t values_nb) const {
-    std::vector<double> values(values_nb);
-    uint64_t pos = start_pos;
-    for (uint32_t i = 0; i < values_nb; ++i) {
-        std::tie(values[i], pos) = readFloat64(pos);
-    }
-    return {values, pos};
+std::pair<uint8_t, uint64_t> GBKFCoreReader::readUInt8(const uint8_t *data, const uint64_t start_pos) {
+    return {data[start_pos], start_pos + 1};
+}
+
+std::pair<uint16_t, uint64_t> GBKFCoreReader::readUInt16(const uint8_t *data, const uint64_t start_pos) {
+    uint16_t value;
+    std::memcpy(&value, data + start_pos, 2);
+    return {value, start_pos + 2};
+}
+
+std::pair<uint32_t, uint64_t> GBKFCoreReader::readUInt32(const uint8_t *data, const uint64_t start_pos) {
+    uint32_t value;
+    std::memcpy(&value, data + start_pos, 4);
+    return {value, start_pos + 4};
+}
+
+std::pair<uint64_t, uint64_t> GBKFCoreReader::readUInt64(const uint8_t *data, const uint64_t start_pos) {
+    uint64_t value;
+    std::memcpy(&value, data + start_pos, 8);
+    return {value, start_pos + 8};
+}
+
+std::pair<std::vector<bool>, uint64_t> GBKFCoreReader::readValuesBool(const uint8_t *data,
+                                                                      uint64_t start_pos,
+                                                                      const uint32_t values_nb,
+                                                                      const uint8_t last_byte_bools_nb) {
+    std::vector<bool> values;
+    const uint64_t end_pos = readValuesPackedBool(data, start_pos, values_nb, last_byte_bools_nb, values);
+    return {std::move(values), end_pos};
 }
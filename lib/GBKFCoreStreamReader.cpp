@@ -0,0 +1,258 @@
+/*
+    This file is part of gbkf-core-cpp.
+
+ Copyright (c) 2025 Rafael Senties Martinelli.
+
+ Licensed under the Privative-Friendly Source-Shared License (PFSSL) v1.0.
+ You may use, modify, and distribute this file under the terms of that license.
+
+ This software is provided "as is", without warranty of any kind.
+ The authors are not liable for any damages arising from its use.
+
+ See the LICENSE file for more details.
+*/
+
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#include "GBKF/GBKFCore.hxx"
+#include "GBKF/GBKFCoreReader.hxx"
+#include "GBKF/GBKFCoreStreamReader.hxx"
+
+using namespace GBKFCore;
+
+GBKFCoreStreamReader::GBKFCoreStreamReader(std::istream &stream) : m_stream(stream) {
+    readHeader();
+}
+
+GBKFCoreStreamReader::GBKFCoreStreamReader(const std::string &read_path)
+    : m_owned_stream(std::make_unique<std::ifstream>(read_path, std::ios::binary)),
+      m_stream(*m_owned_stream) {
+
+    if (!m_stream) {
+        throw std::runtime_error("Cannot open file");
+    }
+
+    readHeader();
+}
+
+uint8_t GBKFCoreStreamReader::getGBKFVersion() const {
+    return m_gbkf_version;
+}
+
+uint32_t GBKFCoreStreamReader::getSpecificationID() const {
+    return m_specification_id;
+}
+
+uint16_t GBKFCoreStreamReader::getSpecificationVersion() const {
+    return m_specification_version;
+}
+
+uint8_t GBKFCoreStreamReader::getKeysSize() const {
+    return m_keys_size;
+}
+
+uint32_t GBKFCoreStreamReader::getKeyedValuesNb() const {
+    return m_keyed_values_nb;
+}
+
+bool GBKFCoreStreamReader::nextRecord() {
+
+    if (m_finished) {
+        return false;
+    }
+
+    if (m_values_pending) {
+        skipEntry();
+    }
+
+    if (m_records_read == m_keyed_values_nb) {
+        readFooter();
+        m_finished = true;
+        return false;
+    }
+
+    // Read the record header
+    std::vector<uint8_t> &header = m_values;
+    header.resize(m_keys_size + KEYED_VALUES_HEADER_SIZE);
+    readBytes(header.data(), header.size());
+
+    const auto *key_ptr = reinterpret_cast<const char *>(header.data());
+    m_key.assign(key_ptr, std::find(key_ptr, key_ptr + m_keys_size, '\0'));
+
+    uint8_t values_type;
+    uint64_t current_pos = m_keys_size;
+    std::tie(m_record.instance_id, current_pos) = GBKFCoreReader::readUInt32(header.data(), current_pos);
+    std::tie(values_type, current_pos) = GBKFCoreReader::readUInt8(header.data(), current_pos);
+    std::tie(m_record.values_nb, current_pos) = GBKFCoreReader::readUInt32(header.data(), current_pos);
+
+    m_record.key = m_key;
+    m_record.compressed = (values_type & CompressedValues::TYPE_FLAG) != 0;
+    m_record.type = static_cast<ValueType>(values_type & ~CompressedValues::TYPE_FLAG);
+    m_record.values_pos = 0;
+
+    // Read the bytes that store the size of the compressed or string values
+    m_values.clear();
+    if (m_record.compressed) {
+        m_values.resize(CompressedValues::HEADER_SIZE);
+        readBytes(m_values.data(), CompressedValues::HEADER_SIZE);
+
+    } else if (m_record.type == ValueType::STRING) {
+        m_values.resize(2);
+        readBytes(m_values.data(), 2);
+
+        if (GBKFCoreReader::readUInt16(m_values.data(), 0).first == 0) {
+            m_values.resize(2 + 4);
+            readBytes(m_values.data() + 2, 4);
+        }
+    }
+
+    m_record.end_pos = GBKFCoreReader::readValuesSize(m_values.data(), m_values.size(), m_record);
+
+    ++m_records_read;
+    m_values_pending = true;
+
+    return true;
+}
+
+const KeyedRecord &GBKFCoreStreamReader::getRecord() const {
+    if (m_records_read == 0 || m_finished) {
+        throw std::runtime_error("No record to read");
+    }
+    return m_record;
+}
+
+KeyedEntry GBKFCoreStreamReader::readEntry() {
+    if (!m_values_pending) {
+        throw std::runtime_error("No record to read");
+    }
+
+    readValues(true);
+
+    if (m_record.compressed) {
+        m_decompressed_values = GBKFCoreReader::decompressValues(m_values.data(), m_record);
+        return GBKFCoreReader::readKeyedEntry(m_decompressed_values.data(),
+                                              GBKFCoreReader::decompressedRecord(m_record, m_decompressed_values));
+    }
+
+    return GBKFCoreReader::readKeyedEntry(m_values.data(), m_record);
+}
+
+std::vector<std::string_view> GBKFCoreStreamReader::readStringViews() {
+    if (!m_values_pending) {
+        throw std::runtime_error("No record to read");
+    }
+
+    if (m_record.type != ValueType::STRING) {
+        throw std::runtime_error("Type mismatch on string values");
+    }
+
+    readValues(true);
+
+    if (m_record.compressed) {
+        m_decompressed_values = GBKFCoreReader::decompressValues(m_values.data(), m_record);
+        return GBKFCoreReader::readStringViews(m_decompressed_values.data(),
+                                               GBKFCoreReader::decompressedRecord(m_record, m_decompressed_values));
+    }
+
+    return GBKFCoreReader::readStringViews(m_values.data(), m_record);
+}
+
+void GBKFCoreStreamReader::skipEntry() {
+    if (!m_values_pending) {
+        throw std::runtime_error("No record to read");
+    }
+
+    readValues(false);
+}
+
+bool GBKFCoreStreamReader::verifiesSha() const {
+    return m_finished && m_sha256_read == m_sha256_calculated && !m_sha256_read.empty();
+}
+
+void GBKFCoreStreamReader::readHeader() {
+
+    uint16_t num = 1;
+    if (*reinterpret_cast<uint8_t*>(&num) != 1) {
+        throw std::runtime_error("System is not little-endian. Unsupported platform.");
+    }
+
+    uint8_t header[Header::SIZE];
+    m_stream.read(reinterpret_cast<char *>(header), Header::SIZE);
+
+    if (m_stream.gcount() != Header::SIZE) {
+        throw std::runtime_error("Header too short");
+    }
+
+    if (memcmp(header, Header::GBKF_KEYWORD, Header::GBKF_KEYWORD_SIZE) != 0) {
+        throw std::invalid_argument("Invalid start keyword");
+    }
+
+    m_sha256.update(header, Header::SIZE);
+
+    m_gbkf_version = GBKFCoreReader::readUInt8(header, Header::GBKF_VERSION_START).first;
+    m_specification_id = GBKFCoreReader::readUInt32(header, Header::SPECIFICATION_ID_START).first;
+    m_specification_version = GBKFCoreReader::readUInt16(header, Header::SPECIFICATION_VERSION_START).first;
+    m_keys_size = GBKFCoreReader::readUInt8(header, Header::KEYS_SIZE_START).first;
+    m_keyed_values_nb = GBKFCoreReader::readUInt32(header, Header::KEYED_VALUES_NB_START).first;
+
+    m_records_read = 0;
+    m_values_pending = false;
+    m_finished = false;
+}
+
+void GBKFCoreStreamReader::readFooter() {
+
+    // The footer is the last FOOTER_SIZE bytes of the stream, any byte before it is part of the hash.
+    std::vector<uint8_t> tail;
+    std::vector<uint8_t> chunk(SKIP_CHUNK_SIZE);
+
+    while (m_stream) {
+        m_stream.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        tail.insert(tail.end(), chunk.begin(), chunk.begin() + m_stream.gcount());
+
+        if (tail.size() > FOOTER_SIZE) {
+            const uint64_t hashed_size = tail.size() - FOOTER_SIZE;
+            m_sha256.update(tail.data(), hashed_size);
+            tail.erase(tail.begin(), tail.begin() + static_cast<std::ptrdiff_t>(hashed_size));
+        }
+    }
+
+    if (tail.size() == FOOTER_SIZE) {
+        m_sha256_read = tail;
+        m_sha256_calculated = m_sha256.digest();
+    }
+}
+
+void GBKFCoreStreamReader::readBytes(uint8_t *destination, const uint64_t size) {
+    m_stream.read(reinterpret_cast<char *>(destination), static_cast<std::streamsize>(size));
+
+    if (static_cast<uint64_t>(m_stream.gcount()) != size) {
+        throw std::runtime_error("Keyed values out of bounds");
+    }
+
+    m_sha256.update(destination, size);
+}
+
+void GBKFCoreStreamReader::readValues(const bool decode) {
+
+    const uint64_t prefix_size = m_values.size();
+    uint64_t remaining_size = m_record.end_pos - prefix_size;
+
+    if (decode) {
+        m_values.resize(m_record.end_pos);
+        readBytes(m_values.data() + prefix_size, remaining_size);
+
+    } else {
+        m_values.resize(std::min(remaining_size, SKIP_CHUNK_SIZE));
+        while (remaining_size > 0) {
+            const uint64_t chunk_size = std::min(remaining_size, SKIP_CHUNK_SIZE);
+            readBytes(m_values.data(), chunk_size);
+            remaining_size -= chunk_size;
+        }
+    }
+
+    m_values_pending = false;
+}
@@ -17,18 +17,146 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
-
-#ifdef USE_OPEN_SSL
-    #include <openssl/sha.h>;
-#else
-#include "GBKF/picosha2.hxx"
-#endif
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <filesystem>
 
 #include "GBKF/GBKFCore.hxx"
 #include "GBKF/GBKFCoreWriter.hxx"
+#include "GBKF/GBKFCoreReader.hxx"
+#include "GBKF/GBKFCoreSha256.hxx"
+#include "GBKF/GBKFCoreCompression.hxx"
+#include "GBKF/GBKFCoreBitmap.hxx"
 
 using namespace GBKFCore;
 
+namespace {
+    // Writes the value at the destination (little-endian, like the host) and returns the next position.
+    template<typename T>
+    uint8_t *writeValue(uint8_t *destination, const T &value) {
+        std::memcpy(destination, &value, sizeof(T));
+        return destination + sizeof(T);
+    }
+}
+
+struct GBKFCoreWriter::Stream {
+    std::fstream file;
+    uint64_t size = 0;                // Records bytes already written
+    Sha256 sha;
+    std::vector<uint8_t> sha_header;  // Header of the hash, set on the first flush
+    bool sha_header_hashed = false;
+
+    // Append mode: the records already in the file are not in sha, so close() hashes the file back
+    bool appended = false;
+    uint64_t appended_file_size = 0;  // Size of the file before appending, it is truncated if it gets smaller
+
+    // Asynchronous mode: the buffers keep the header space, so they are swapped with the writer buffer as they are
+    uint32_t async_buffers_nb = 0;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::vector<uint8_t> > pending_buffers;
+    std::vector<std::vector<uint8_t> > free_buffers;
+    bool writing = false;
+    bool stopping = false;
+    std::exception_ptr error;
+    std::thread thread;
+
+    std::shared_ptr<StatsCounters> stats;
+
+    ~Stream() {
+        stopWriter(true);
+    }
+
+    void writeRecords(const uint8_t *records, const uint64_t records_size) {
+        if (!sha_header_hashed && !appended) {
+            sha.update(sha_header.data(), sha_header.size());
+            sha_header_hashed = true;
+        }
+
+        if (records_size == 0) {
+            return;
+        }
+
+        if (!appended) {
+            GBKF_STATS_TIMER(stats, hash_ns);
+            sha.update(records, records_size);
+        }
+        {
+            GBKF_STATS_TIMER(stats, io_ns);
+            file.write(reinterpret_cast<const char *>(records), static_cast<std::streamsize>(records_size));
+        }
+        GBKF_STATS_ADD(stats, bytes_written, records_size);
+
+        if (!file) {
+            throw std::runtime_error("Cannot write the file");
+        }
+
+        size += records_size;
+    }
+
+    // Loop of the background thread
+    void runWriter() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            condition.wait(lock, [this]() { return stopping || !pending_buffers.empty(); });
+            if (pending_buffers.empty()) {
+                return;
+            }
+
+            std::vector<uint8_t> buffer = std::move(pending_buffers.front());
+            pending_buffers.pop_front();
+            const bool failed = error != nullptr;
+            writing = true;
+            lock.unlock();
+
+            // After an error, the buffers are discarded
+            std::exception_ptr buffer_error;
+            if (!failed) {
+                try {
+                    writeRecords(buffer.data() + Header::SIZE, buffer.size() - Header::SIZE);
+                } catch (...) {
+                    buffer_error = std::current_exception();
+                }
+            }
+
+            lock.lock();
+            if (buffer_error && !error) {
+                error = buffer_error;
+            }
+            writing = false;
+            free_buffers.push_back(std::move(buffer));
+            condition.notify_all();
+        }
+    }
+
+    // Waits until the background thread wrote all the buffers
+    void waitWriter() {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() { return (pending_buffers.empty() && !writing) || error; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void stopWriter(const bool discard) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (discard) {
+                pending_buffers.clear();
+            }
+            stopping = true;
+        }
+        condition.notify_all();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
 GBKFCoreWriter::GBKFCoreWriter() {
 
     uint16_t num = 1;
@@ -38,15 +166,124 @@ GBKFCoreWriter::GBKFCoreWriter() {
 
     m_keyed_values_nb = 0;
     m_keys_size = 1;
+    initStats();
     reset();
 }
 
+GBKFCoreWriter::GBKFCoreWriter(const std::string &write_path,
+                               const uint64_t stream_buffer_size,
+                               const uint32_t async_buffers_nb) : GBKFCoreWriter() {
+
+    if (stream_buffer_size == 0) {
+        throw std::invalid_argument("The stream buffer size can not be 0");
+    }
+
+    m_stream_path = write_path;
+    m_stream_buffer_size = stream_buffer_size;
+    m_stream_async_buffers_nb = async_buffers_nb;
+    m_byte_buffer.reserve(Header::SIZE + m_stream_buffer_size);
+
+    openStream();
+}
+
+GBKFCoreWriter GBKFCoreWriter::openAppend(const std::string &path,
+                                          const uint64_t stream_buffer_size,
+                                          const uint32_t async_buffers_nb) {
+
+    if (stream_buffer_size == 0) {
+        throw std::invalid_argument("The stream buffer size can not be 0");
+    }
+
+    GBKFCoreWriter writer;
+    writer.m_stream_path = path;
+    writer.m_stream_buffer_size = stream_buffer_size;
+    writer.m_stream_async_buffers_nb = async_buffers_nb;
+    writer.m_byte_buffer.reserve(Header::SIZE + stream_buffer_size);
+
+    writer.openAppendStream();
+    return writer;
+}
+
+GBKFCoreWriter::GBKFCoreWriter(GBKFCoreWriter &&) noexcept = default;
+
+GBKFCoreWriter &GBKFCoreWriter::operator=(GBKFCoreWriter &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    // The file of this writer is completed first, like by the destructor
+    closeOpenStream();
+
+    m_byte_buffer = std::move(other.m_byte_buffer);
+    m_buffer_sha = other.m_buffer_sha;
+    m_buffer_sha_size = other.m_buffer_sha_size;
+    m_buffer_sha_header = std::move(other.m_buffer_sha_header);
+
+    m_keys_size = other.m_keys_size;
+    m_keyed_values_nb = other.m_keyed_values_nb;
+    m_keys = std::move(other.m_keys);
+    m_keys_min_length = other.m_keys_min_length;
+    m_keys_max_length = other.m_keys_max_length;
+
+    m_stream_path = std::move(other.m_stream_path);
+    m_stream_buffer_size = other.m_stream_buffer_size;
+    m_stream_async_buffers_nb = other.m_stream_async_buffers_nb;
+    m_stream = std::move(other.m_stream);
+
+    m_index_block = other.m_index_block;
+    m_index_entries = std::move(other.m_index_entries);
+    m_buffer_offset = other.m_buffer_offset;
+
+    m_compression = other.m_compression;
+    m_compression_level = other.m_compression_level;
+    m_compression_chunk_size = other.m_compression_chunk_size;
+    m_record_values_pos = other.m_record_values_pos;
+
+    m_stats = std::move(other.m_stats);
+    return *this;
+}
+
+void GBKFCoreWriter::initStats() {
+#ifdef GBKF_STATS
+    m_stats = std::make_shared<StatsCounters>();
+#endif
+}
+
+Stats GBKFCoreWriter::getStats() const {
+    return m_stats ? m_stats->snapshot() : Stats();
+}
+
+void GBKFCoreWriter::resetStats() {
+    if (m_stats) {
+        m_stats->reset();
+    }
+}
+
+GBKFCoreWriter::~GBKFCoreWriter() {
+    closeOpenStream();
+}
+
+void GBKFCoreWriter::closeOpenStream() noexcept {
+    if (m_stream && m_stream->file.is_open()) {
+        try {
+            close();
+        } catch (...) {
+            // Destructors must not throw, call close() to handle the errors.
+        }
+    }
+}
+
 void GBKFCoreWriter::reset() {
     m_byte_buffer.assign(Header::SIZE, 0);
     std::memcpy(m_byte_buffer.data(), Header::GBKF_KEYWORD, Header::GBKF_KEYWORD_SIZE);
 
     m_keyed_values_nb = 0;
+    m_buffer_sha_header.clear();
+    m_buffer_offset = 0;
+    m_index_entries.clear();
     m_keys.clear();
+    m_keys_min_length = 0;
+    m_keys_max_length = 0;
     m_keys_size = 1;
 
     setGBKFVersion();
@@ -54,6 +291,12 @@ void GBKFCoreWriter::reset() {
     setSpecificationVersion();
     setKeysSize();
     setKeyedValuesNb();
+
+    if (isStreaming()) {
+        // Discard the records already flushed
+        m_stream.reset();
+        openStream();
+    }
 }
 
 void GBKFCoreWriter::setGBKFVersion(const uint8_t value) {
@@ -74,10 +317,8 @@ void GBKFCoreWriter::setKeysSize(const uint8_t value) {
         throw std::invalid_argument("Key length can not be lower than 1");
     }
 
-    for (const auto &key: m_keys) {
-        if (key.length() != static_cast<size_t>(value)) {
-            throw std::invalid_argument("Key length mismatch");
-        };
+    if (!m_keys.empty() && (m_keys_min_length != value || m_keys_max_length != value)) {
+        throw std::invalid_argument("Key length mismatch");
     }
 
     setUInt8(value, Header::KEYS_SIZE_START);
@@ -92,22 +333,59 @@ void GBKFCoreWriter::setKeyedValuesNbAuto() {
     setKeyedValuesNb(m_keyed_values_nb);
 }
 
-void GBKFCoreWriter::addKeyedValuesBlob(const std::string &key,
-                                         const uint32_t instance_id,
-                                         const std::vector<uint8_t> &values) {
-     // Add the header
-     writeKeyedValuesHeader(key, instance_id, values.size(), ValueType::BLOB);
+void GBKFCoreWriter::reserve(const uint64_t bytes) {
+    // At most one record per record header in the bytes
+    reserveBuffer(bytes, bytes / (m_keys_size + KEYED_VALUES_HEADER_SIZE));
+}
 
-    // Add the values
-    m_byte_buffer.insert(m_byte_buffer.end(), values.begin(), values.end());
+void GBKFCoreWriter::reserveRecords(const uint64_t records_nb, const uint64_t values_size) {
+    reserveBuffer(records_nb * (m_keys_size + KEYED_VALUES_HEADER_SIZE + values_size), records_nb);
+}
 
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+void GBKFCoreWriter::reserveBuffer(const uint64_t bytes, const uint64_t records_nb) {
+    // Also reserve the index block and the footer, so takeBytesBuffer() can append them without reallocation
+    uint64_t index_block_size = 0;
+    if (m_index_block) {
+        const uint64_t entries_nb = std::min<uint64_t>(m_index_entries.size() + records_nb, (uint64_t(1) << 31) - 1);
+        index_block_size = IndexBlock::size(m_keys_size, static_cast<uint32_t>(entries_nb));
+    }
+    m_byte_buffer.reserve(m_byte_buffer.size() + bytes + index_block_size + FOOTER_SIZE);
+}
 
-    // Add the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
+void GBKFCoreWriter::setIndexBlock(const bool enabled) {
+    if (m_keyed_values_nb > 0) {
+        throw std::runtime_error("The index block must be set before adding keyed-values");
     }
+    m_index_block = enabled;
+}
+
+void GBKFCoreWriter::setCompression(const Compression compression, const int level, const uint32_t chunk_size) {
+    if (compression != Compression::NONE && !Codecs::isAvailable(compression)) {
+        throw std::invalid_argument("Compression not available in this build");
+    }
+
+    // The delta chunks hold whole values
+    if (chunk_size == 0 || chunk_size > CompressedValues::MAX_CHUNK_SIZE ||
+        (compression == Compression::DELTA && chunk_size % 8 != 0)) {
+        throw std::invalid_argument("Compression chunk size out of bounds");
+    }
+
+    m_compression = compression;
+    m_compression_level = level;
+    m_compression_chunk_size = chunk_size;
+}
+
+void GBKFCoreWriter::addKeyedValuesBlob(const std::string &key,
+                                        const uint32_t instance_id,
+                                        const std::vector<uint8_t> &values) {
+    addKeyedValuesBlob(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
+
+void GBKFCoreWriter::addKeyedValuesBlob(const std::string &key,
+                                        const uint32_t instance_id,
+                                        const uint8_t *values,
+                                        const uint32_t values_nb) {
+    addKeyedValuesFixedSize(key, instance_id, ValueType::BLOB, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesStringUTF8(const std::string &key,
@@ -115,386 +393,468 @@ void GBKFCoreWriter::addKeyedValuesStringUTF8(const std::string &key,
                                               const std::vector<std::string> &values,
                                               const uint16_t max_size) {
 
+    // Compute the values size, so the record is written without intermediate buffers
+    uint64_t values_size = 2;
+
+    if (max_size == 0) {
+        // Dynamic strings: the values bytes-size, then each string prefixed by its size
+        uint64_t values_bytes_size = 0;
+        for (const std::string &str: values) {
+            const std::string_view normalized_string = normalizeString(str);
+            if (normalized_string.size() > UINT16_MAX) {
+                throw std::invalid_argument("String out of bounds");
+            }
+            values_bytes_size += 2 + normalized_string.size();
+        }
+
+        if (values_bytes_size > UINT32_MAX) {
+            throw std::invalid_argument("Strings out of bounds");
+        }
+        values_size += 4 + values_bytes_size;
+
+    } else {
+        // Fixed size strings, padded with NUL
+        for (const std::string &str: values) {
+            if (normalizeString(str).size() > max_size) {
+                throw std::invalid_argument("String out of bounds");
+            }
+        }
+        values_size += static_cast<uint64_t>(max_size) * values.size();
+    }
+
     // Add the header
-    writeKeyedValuesHeader(key, instance_id, values.size(), ValueType::STRING);
+    uint8_t *values_ptr = writeKeyedValuesHeader(key, instance_id, values.size(), ValueType::STRING, values_size);
 
     // Push the maximum string size ( 0 for dynamic strings )
-    const auto uint8_max_size = formatUInt16(max_size);
-    m_byte_buffer.insert(m_byte_buffer.end(), uint8_max_size.begin(), uint8_max_size.end());
-
-    // Populate the Values
-    std::vector<uint8_t> values_content;
+    values_ptr = writeValue(values_ptr, max_size);
 
     if (max_size == 0) {
         //
         // Dynamic Strings
         //
 
-        for (const std::string &str: values) {
-            auto normalized_string = normalizeString(str);
-
-            // Set the string size
-            auto string_size = formatUInt16(normalized_string.size());
-            values_content.insert(values_content.end(), string_size.begin(), string_size.end());
-
-            // Set the value
-            std::vector<uint8_t> buffer(normalized_string.size(), 0);
-            std::copy(normalized_string.begin(), normalized_string.end(), buffer.begin());
+        values_ptr = writeValue(values_ptr, static_cast<uint32_t>(values_size - 2 - 4));
 
-            values_content.insert(values_content.end(), buffer.begin(), buffer.end());
+        for (const std::string &str: values) {
+            const std::string_view normalized_string = normalizeString(str);
+            values_ptr = writeValue(values_ptr, static_cast<uint16_t>(normalized_string.size()));
+            values_ptr = std::copy(normalized_string.begin(), normalized_string.end(), values_ptr);
         }
 
-        // Add the values bytes-size
-        const auto values_bytes_size = formatUInt32(values_content.size());
-        m_byte_buffer.insert(m_byte_buffer.end(), values_bytes_size.begin(), values_bytes_size.end());
-
     }else {
         //
-        // Fixed size strings
+        // Fixed size strings (the buffer is already filled with NUL)
         //
 
         for (const std::string &str: values) {
-            auto normalized_string = normalizeString(str);
+            const std::string_view normalized_string = normalizeString(str);
+            std::copy(normalized_string.begin(), normalized_string.end(), values_ptr);
+            values_ptr += max_size;
+        }
+    }
 
-            if (normalized_string.size() > max_size) {
-                throw std::invalid_argument("String out of bounds");
-            }
+    endKeyedValues(key);
+}
 
-            std::vector<uint8_t> buffer(max_size, 0);
-            std::copy(normalized_string.begin(), normalized_string.end(), buffer.begin());
 
-            values_content.insert(values_content.end(), buffer.begin(), buffer.end());
+void GBKFCoreWriter::addKeyedValuesBoolean(const std::string &key,
+                                           const uint32_t instance_id,
+                                           const std::vector<bool> &values) {
+    uint8_t *packed = writeBooleanHeader(key, instance_id, values.size());
 
+    // Pack the booleans into the bytes (LSB-first), a byte at a time
+    for (size_t i = 0; i < values.size(); i += 8) {
+        uint8_t byte = 0;
+        for (size_t bit = 0; bit < 8 && i + bit < values.size(); ++bit) {
+            byte |= static_cast<uint8_t>(values[i + bit] << bit);
         }
+        packed[i / 8] = byte;
     }
 
-    // Add the values
-    m_byte_buffer.insert(m_byte_buffer.end(), values_content.begin(), values_content.end());
+    endKeyedValues(key);
+}
 
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+void GBKFCoreWriter::addKeyedValuesBoolean(const std::string &key,
+                                           const uint32_t instance_id,
+                                           const bool *values,
+                                           const uint32_t values_nb) {
+    Bitmap::pack(values, values_nb, writeBooleanHeader(key, instance_id, values_nb));
+    endKeyedValues(key);
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
+void GBKFCoreWriter::addKeyedValuesBitmap(const std::string &key,
+                                          const uint32_t instance_id,
+                                          const uint8_t *packed,
+                                          const uint32_t bits_nb) {
+    uint8_t *destination = writeBooleanHeader(key, instance_id, bits_nb);
+
+    const uint64_t bytes_nb = Bitmap::bytesNb(bits_nb);
+    if (bytes_nb > 0) {
+        std::memcpy(destination, packed, bytes_nb);
+        if (bits_nb % 8 != 0) {
+            destination[bytes_nb - 1] &= static_cast<uint8_t>((1 << (bits_nb % 8)) - 1);
+        }
     }
-}
 
+    endKeyedValues(key);
+}
 
-void GBKFCoreWriter::addKeyedValuesBoolean(const std::string &key,
-                                           const uint32_t instance_id,
-                                           const std::vector<bool> &values) {
-    // Add the header
-    writeKeyedValuesHeader(key, instance_id, values.size(), ValueType::BOOLEAN);
+uint8_t *GBKFCoreWriter::writeBooleanHeader(const std::string &key,
+                                            const uint32_t instance_id,
+                                            const uint32_t values_nb) {
+    // Add the header, the values are the last byte number of used booleans and the packed bytes: ceil(size/8)
+    const uint64_t packed_size = Bitmap::bytesNb(values_nb);
+    uint8_t *values_ptr = writeKeyedValuesHeader(key, instance_id, values_nb, ValueType::BOOLEAN, 1 + packed_size);
 
     // Set the last byte number of used booleans
-    uint8_t last_bools_nb = values.size() % 8;
-    if (last_bools_nb == 0 && !values.empty()) {
+    uint8_t last_bools_nb = values_nb % 8;
+    if (last_bools_nb == 0 && values_nb > 0) {
         last_bools_nb = 8;
     }
-    m_byte_buffer.push_back(last_bools_nb);
-
-    // Pack the booleans into bytes
-    std::vector<uint8_t> packed((values.size() + 7) / 8, 0); // ceil(size/8)
-    for (size_t i = 0; i < values.size(); ++i) {
-        if (values[i]) {
-            packed[i / 8] |= (1 << (i % 8)); // LSB-first packing
-        }
-    }
-    m_byte_buffer.insert(m_byte_buffer.end(), packed.begin(), packed.end());
+    return writeValue(values_ptr, last_bools_nb);
+}
 
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+void GBKFCoreWriter::endKeyedValues(const std::string &key) {
+    compressRecord();
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+    // Increment the keyed-values count and store the key
+    registerKeyedValues(key);
 }
 
 void GBKFCoreWriter::addKeyedValuesInt8(const std::string &key,
                                         const uint32_t instance_id,
                                         const std::vector<int8_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::INT8);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(int8_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesInt8(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesInt8(const std::string &key,
+                                        const uint32_t instance_id,
+                                        const int8_t *values,
+                                        const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesInt16(const std::string &key,
                                          const uint32_t instance_id,
                                          const std::vector<int16_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::INT16);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(int16_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesInt16(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesInt16(const std::string &key,
+                                         const uint32_t instance_id,
+                                         const int16_t *values,
+                                         const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesInt32(const std::string &key,
                                          const uint32_t instance_id,
                                          const std::vector<int32_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::INT32);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(int32_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesInt32(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesInt32(const std::string &key,
+                                         const uint32_t instance_id,
+                                         const int32_t *values,
+                                         const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesInt64(const std::string &key,
                                          const uint32_t instance_id,
                                          const std::vector<int64_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::INT64);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(int64_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesInt64(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesInt64(const std::string &key,
+                                         const uint32_t instance_id,
+                                         const int64_t *values,
+                                         const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesUInt8(const std::string &key,
                                          const uint32_t instance_id,
                                          const std::vector<uint8_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::UINT8);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(uint8_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesUInt8(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesUInt8(const std::string &key,
+                                         const uint32_t instance_id,
+                                         const uint8_t *values,
+                                         const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesUInt16(const std::string &key,
                                           const uint32_t instance_id,
                                           const std::vector<uint16_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::UINT16);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(uint16_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesUInt16(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesUInt16(const std::string &key,
+                                          const uint32_t instance_id,
+                                          const uint16_t *values,
+                                          const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesUInt32(const std::string &key,
                                           const uint32_t instance_id,
                                           const std::vector<uint32_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::UINT32);
-
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(uint32_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
-
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
-
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    addKeyedValuesUInt32(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesUInt32(const std::string &key,
+                                          const uint32_t instance_id,
+                                          const uint32_t *values,
+                                          const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
 }
 
 void GBKFCoreWriter::addKeyedValuesUInt64(const std::string &key,
                                           const uint32_t instance_id,
                                           const std::vector<uint64_t> &values) {
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::UINT64);
+    addKeyedValuesUInt64(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(uint64_t);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
+void GBKFCoreWriter::addKeyedValuesUInt64(const std::string &key,
+                                          const uint32_t instance_id,
+                                          const uint64_t *values,
+                                          const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
+}
 
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
+void GBKFCoreWriter::addKeyedValuesFloat32(const std::string &key,
+                                           const uint32_t instance_id,
+                                           const std::vector<float> &values) {
+    addKeyedValuesFloat32(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+}
 
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+void GBKFCoreWriter::addKeyedValuesFloat32(const std::string &key,
+                                           const uint32_t instance_id,
+                                           const float *values,
+                                           const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
+}
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
-    }
+void GBKFCoreWriter::addKeyedValuesFloat64(const std::string &key,
+                                           const uint32_t instance_id,
+                                           const std::vector<double> &values) {
+    addKeyedValuesFloat64(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
 }
 
-void GBKFCoreWriter::addKeyedValuesFloat32(const std::string &key,
+void GBKFCoreWriter::addKeyedValuesFloat64(const std::string &key,
                                            const uint32_t instance_id,
-                                           const std::vector<float> &values) {
+                                           const double *values,
+                                           const uint32_t values_nb) {
+    addKeyedValues(key, instance_id, values, values_nb);
+}
 
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::FLOAT32);
+template<typename T>
+void GBKFCoreWriter::addKeyedValues(const std::string &key,
+                                    const uint32_t instance_id,
+                                    const T *values,
+                                    const uint32_t values_nb) {
+    addKeyedValuesFixedSize(key, instance_id, KeyedEntry::deduceValueType<T>(), values, values_nb);
+}
 
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(float);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
+template<typename T>
+void GBKFCoreWriter::addKeyedValues(const std::string &key, const uint32_t instance_id, const std::vector<T> &values) {
+    if constexpr (std::is_same_v<T, bool>) {
+        addKeyedValuesBoolean(key, instance_id, values);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        addKeyedValuesStringUTF8(key, instance_id, values, 0);
+    } else {
+        addKeyedValues(key, instance_id, values.data(), static_cast<uint32_t>(values.size()));
+    }
+}
 
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
+template<typename T>
+void GBKFCoreWriter::addKeyedValuesFixedSize(const std::string &key,
+                                             const uint32_t instance_id,
+                                             const ValueType value_type,
+                                             const T *values,
+                                             const uint32_t values_nb) {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Only fixed-width values are copied");
 
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    // Write the header, with the space for all values
+    const size_t values_bytes = static_cast<size_t>(values_nb) * sizeof(T);
+    uint8_t *values_ptr = writeKeyedValuesHeader(key, instance_id, values_nb, value_type, values_bytes);
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
+    // Copy all values at once
+    if (values_bytes > 0) {
+        std::memcpy(values_ptr, values, values_bytes);
     }
+
+    endKeyedValues(key);
 }
 
-void GBKFCoreWriter::addKeyedValuesFloat64(const std::string &key,
-                                           const uint32_t instance_id,
-                                           const std::vector<double> &values) {
+template<typename T>
+void GBKFCoreWriter::addKeyedValuesColumns(const std::string &key,
+                                           const uint32_t *instance_ids,
+                                           const uint32_t instance_ids_nb,
+                                           const T *values,
+                                           const uint64_t *values_offsets) {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "Only fixed-width values are written as columns");
+
+    if (instance_ids_nb == 0) {
+        return;
+    }
 
-    // Write header first
-    writeKeyedValuesHeader(key, instance_id, static_cast<uint32_t>(values.size()), ValueType::FLOAT64);
+    for (uint32_t i = 0; i < instance_ids_nb; ++i) {
+        if (values_offsets[i + 1] < values_offsets[i] || values_offsets[i + 1] - values_offsets[i] > UINT32_MAX) {
+            throw std::invalid_argument("Invalid values offsets");
+        }
+    }
 
-    // Reserve space for all values
-    const size_t values_bytes = values.size() * sizeof(double);
-    const size_t old_size = m_byte_buffer.size();
-    m_byte_buffer.resize(old_size + values_bytes);
+    const ValueType value_type = KeyedEntry::deduceValueType<T>();
 
-    // Copy all values at once
-    std::memcpy(m_byte_buffer.data() + old_size, values.data(), values_bytes);
+    // Allocate once for all the records, a streaming buffer is flushed in between
+    if (!isStreaming()) {
+        const uint64_t values_nb = values_offsets[instance_ids_nb] - values_offsets[0];
+        m_byte_buffer.reserve(m_byte_buffer.size() +
+                              static_cast<uint64_t>(instance_ids_nb) *
+                              (normalizeString(key).size() + KEYED_VALUES_HEADER_SIZE) +
+                              values_nb * sizeof(T));
+    }
 
-    // Increment the keyed-values count
-    ++m_keyed_values_nb;
+    for (uint32_t i = 0; i < instance_ids_nb; ++i) {
+        const auto record_values_nb = static_cast<uint32_t>(values_offsets[i + 1] - values_offsets[i]);
+        const size_t values_bytes = static_cast<size_t>(record_values_nb) * sizeof(T);
 
-    // Store the key
-    if (std::find(m_keys.begin(), m_keys.end(), key) == m_keys.end()) {
-        m_keys.push_back(key);
+        uint8_t *values_ptr = writeKeyedValuesHeader(key, instance_ids[i], record_values_nb, value_type, values_bytes);
+        if (values_bytes > 0) {
+            std::memcpy(values_ptr, values + values_offsets[i], values_bytes);
+        }
+
+        // Count each record as it is written, like addKeyedValues()
+        registerKeyedValues(key);
     }
+}
 
-};
+template<typename T>
+void GBKFCoreWriter::addKeyedValuesColumns(const std::string &key,
+                                           const std::vector<uint32_t> &instance_ids,
+                                           const std::vector<T> &values,
+                                           const std::vector<uint64_t> &values_offsets) {
+    if (instance_ids.empty() && values_offsets.size() <= 1) {
+        return;
+    }
+
+    if (values_offsets.size() != instance_ids.size() + 1 || values_offsets.back() > values.size() ||
+        instance_ids.size() > UINT32_MAX) {
+        throw std::invalid_argument("The values offsets do not match the instance ids and the values");
+    }
+
+    addKeyedValuesColumns(key,
+                          instance_ids.data(),
+                          static_cast<uint32_t>(instance_ids.size()),
+                          values.data(),
+                          values_offsets.data());
+}
+
+// The fixed-width types of the format
+#define GBKF_INSTANTIATE_FIXED_SIZE(T) \
+    template void GBKFCoreWriter::addKeyedValues<T>(const std::string &, uint32_t, const T *, uint32_t); \
+    template void GBKFCoreWriter::addKeyedValues<T>(const std::string &, uint32_t, const std::vector<T> &); \
+    template void GBKFCoreWriter::addKeyedValuesColumns<T>( \
+        const std::string &, const uint32_t *, uint32_t, const T *, const uint64_t *); \
+    template void GBKFCoreWriter::addKeyedValuesColumns<T>( \
+        const std::string &, const std::vector<uint32_t> &, const std::vector<T> &, const std::vector<uint64_t> &);
+
+GBKF_INSTANTIATE_FIXED_SIZE(int8_t)
+GBKF_INSTANTIATE_FIXED_SIZE(int16_t)
+GBKF_INSTANTIATE_FIXED_SIZE(int32_t)
+GBKF_INSTANTIATE_FIXED_SIZE(int64_t)
+GBKF_INSTANTIATE_FIXED_SIZE(uint8_t)
+GBKF_INSTANTIATE_FIXED_SIZE(uint16_t)
+GBKF_INSTANTIATE_FIXED_SIZE(uint32_t)
+GBKF_INSTANTIATE_FIXED_SIZE(uint64_t)
+GBKF_INSTANTIATE_FIXED_SIZE(float)
+GBKF_INSTANTIATE_FIXED_SIZE(double)
+
+#undef GBKF_INSTANTIATE_FIXED_SIZE
+
+template void GBKFCoreWriter::addKeyedValues<bool>(const std::string &, uint32_t, const std::vector<bool> &);
+template void GBKFCoreWriter::addKeyedValues<std::string>(const std::string &,
+                                                          uint32_t,
+                                                          const std::vector<std::string> &);
 
 void GBKFCoreWriter::write(const std::string &write_path,
                            const bool auto_update,
                            const bool add_footer) {
+    if (isStreaming()) {
+        throw std::runtime_error("Streaming writers are written by close()");
+    }
+
     if (auto_update) {
         setKeyedValuesNbAuto();
     }
 
     std::ofstream file(write_path, std::ios::binary);
 
-    file.write(reinterpret_cast<const char *>(m_byte_buffer.data()),
-               static_cast<std::streamsize>(m_byte_buffer.size()));
+    if (!file) {
+        throw std::runtime_error("Cannot open file");
+    }
 
+    // Hash and write in a single pass, each chunk is hashed (unless it was before) while it is in the cache.
+    for (uint64_t pos = 0; pos < m_byte_buffer.size(); pos += WRITE_CHUNK_SIZE) {
+        const uint64_t chunk_size = std::min<uint64_t>(WRITE_CHUNK_SIZE, m_byte_buffer.size() - pos);
+
+        if (add_footer) {
+            updateBufferSha(pos + chunk_size);
+        }
+
+        GBKF_STATS_TIMER(m_stats, io_ns);
+        file.write(reinterpret_cast<const char *>(m_byte_buffer.data() + pos),
+                   static_cast<std::streamsize>(chunk_size));
+    }
+    GBKF_STATS_ADD(m_stats, bytes_written, m_byte_buffer.size());
+
+    const std::vector<uint8_t> index_block = buildIndexBlock(m_byte_buffer.size());
+    file.write(reinterpret_cast<const char *>(index_block.data()), static_cast<std::streamsize>(index_block.size()));
+    GBKF_STATS_ADD(m_stats, bytes_written, index_block.size());
 
     if (add_footer) {
         //
         // The footer must be added by separate, or it will bug in case of multiple writes.
         //
 
-        std::vector<uint8_t> footer_hash(FOOTER_SIZE);
-
-#ifdef USE_OPEN_SSL
-        SHA256(m_byte_buffer.data(), m_byte_buffer.size(), hash.data());
-#else
-        picosha2::hash256(m_byte_buffer.begin(), m_byte_buffer.end(), footer_hash.begin(), footer_hash.end());
-#endif
+        const std::vector<uint8_t> footer_hash = digestBuffer(index_block);
 
         file.write(reinterpret_cast<const char *>(footer_hash.data()),
                    static_cast<std::streamsize>(footer_hash.size()));
+        GBKF_STATS_ADD(m_stats, bytes_written, footer_hash.size());
     };
 
+    if (!file) {
+        throw std::runtime_error("Cannot write the file");
+    }
 }
 
 std::vector<uint8_t> GBKFCoreWriter::getBytesBuffer(const bool auto_update, const bool add_footer) {
+    if (isStreaming()) {
+        throw std::runtime_error("Streaming writers do not keep the bytes buffer");
+    }
 
     if (auto_update) {
         setKeyedValuesNbAuto();
     }
 
-    std::vector<uint8_t> buffer_copy = m_byte_buffer;
-
-    if (add_footer) {
+    const std::vector<uint8_t> index_block = buildIndexBlock(m_byte_buffer.size());
 
-        std::vector<uint8_t> footer_hash(FOOTER_SIZE);
+    // Allocate once for the data, the index and the footer
+    std::vector<uint8_t> buffer_copy;
+    buffer_copy.reserve(m_byte_buffer.size() + index_block.size() + (add_footer ? FOOTER_SIZE : 0));
+    buffer_copy.assign(m_byte_buffer.begin(), m_byte_buffer.end());
+    buffer_copy.insert(buffer_copy.end(), index_block.begin(), index_block.end());
 
-#ifdef USE_OPEN_SSL
-        SHA256(m_byte_buffer.data(), m_byte_buffer.size(), hash.data());
-#else
-        picosha2::hash256(m_byte_buffer.begin(), m_byte_buffer.end(), footer_hash.begin(), footer_hash.end());
-#endif
+    if (add_footer) {
 
+        updateBufferSha(m_byte_buffer.size());
+        const std::vector<uint8_t> footer_hash = digestBuffer(index_block);
 
         // Append extra data
         buffer_copy.insert(buffer_copy.end(), footer_hash.begin(), footer_hash.end());
@@ -504,56 +864,470 @@ std::vector<uint8_t> GBKFCoreWriter::getBytesBuffer(const bool auto_update, cons
 
 };
 
-std::string GBKFCoreWriter::normalizeString(const std::string &input) {
-    std::string result = input;
+std::vector<uint8_t> GBKFCoreWriter::takeBytesBuffer(const bool auto_update, const bool add_footer) {
+    if (isStreaming()) {
+        throw std::runtime_error("Streaming writers do not keep the bytes buffer");
+    }
 
-    // Trim trailing nulls
-    auto end = result.find_last_not_of('\0');
-    if (end != std::string::npos) {
-        result.resize(end + 1);
-    } else {
-        result.clear();
+    if (auto_update) {
+        setKeyedValuesNbAuto();
+    }
+
+    if (add_footer) {
+        updateBufferSha(m_byte_buffer.size());
     }
 
-    return result;
+    const std::vector<uint8_t> index_block = buildIndexBlock(m_byte_buffer.size());
+    std::vector<uint8_t> buffer = std::move(m_byte_buffer);
+    buffer.insert(buffer.end(), index_block.begin(), index_block.end());
+
+    if (add_footer) {
+        const std::vector<uint8_t> footer_hash = digestBuffer(index_block);
+        buffer.insert(buffer.end(), footer_hash.begin(), footer_hash.end());
+    }
+
+    reset();
+
+    return buffer;
 }
 
-void GBKFCoreWriter::writeKeyedValuesHeader(const std::string &key,
-                                            const uint32_t instance_id,
-                                            const uint32_t values_nb,
-                                            ValueType value_type) {
+bool GBKFCoreWriter::isStreaming() const {
+    return m_stream_buffer_size > 0;
+}
 
-    // Add the key
-    auto key_bytes = formatKey(key);
-    m_byte_buffer.insert(m_byte_buffer.end(), key_bytes.begin(), key_bytes.end());
+void GBKFCoreWriter::close(const bool auto_update, const bool add_footer) {
+    if (!m_stream || !m_stream->file.is_open()) {
+        throw std::runtime_error("The stream is not open");
+    }
 
-    // Add the instance_id
-    m_byte_buffer.resize(m_byte_buffer.size() + sizeof(instance_id));
-    std::memcpy(m_byte_buffer.data() + m_byte_buffer.size() - sizeof(instance_id), &instance_id, sizeof(instance_id));
+    if (auto_update) {
+        setKeyedValuesNbAuto();
+    }
+
+    Stream &stream = *m_stream;
+
+    // The remaining records are written from this thread, once the background thread is done
+    if (m_stream_async_buffers_nb > 0) {
+        stream.waitWriter();
+        stream.stopWriter(false);
+    }
 
-    // Add value_type
-    m_byte_buffer.push_back(static_cast<uint8_t>(value_type));
+    if (stream.sha_header.empty()) {
+        stream.sha_header.assign(m_byte_buffer.begin(), m_byte_buffer.begin() + Header::SIZE);
+    }
+    stream.writeRecords(m_byte_buffer.data() + Header::SIZE, m_byte_buffer.size() - Header::SIZE);
+    m_byte_buffer.resize(Header::SIZE);
+
+    if (m_index_block) {
+        const std::vector<uint8_t> index_block = buildIndexBlock(Header::SIZE + stream.size);
+        stream.writeRecords(index_block.data(), index_block.size());
+    }
+
+    // Patch the header, which is only known now
+    stream.file.seekp(0);
+    stream.file.write(reinterpret_cast<const char *>(m_byte_buffer.data()), Header::SIZE);
+    GBKF_STATS_ADD(m_stats, bytes_written, Header::SIZE);
+
+    if (add_footer) {
+        std::vector<uint8_t> footer_hash;
+
+        if (!stream.appended &&
+            std::equal(stream.sha_header.begin(), stream.sha_header.end(), m_byte_buffer.begin())) {
+            // The header did not change since the hash was started
+            footer_hash = stream.sha.digest();
+
+        } else {
+            // The header changed after the first flush (e.g. the keyed-values count), or the file was appended,
+            // so the file is hashed again, reading it back by chunks.
+            GBKF_STATS_TIMER(m_stats, hash_ns);
+            Sha256 sha256;
+            sha256.update(m_byte_buffer.data(), Header::SIZE);
+
+            std::vector<uint8_t> chunk(m_stream_buffer_size);
+            uint64_t remaining_size = stream.size;
+
+            stream.file.seekg(Header::SIZE);
+            while (remaining_size > 0) {
+                const uint64_t chunk_size = std::min(remaining_size, m_stream_buffer_size);
+                stream.file.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunk_size));
+                sha256.update(chunk.data(), chunk_size);
+                remaining_size -= chunk_size;
+            }
+
+            footer_hash = sha256.digest();
+        }
 
-    // Add the values_nb
-    m_byte_buffer.resize(m_byte_buffer.size() + sizeof(values_nb));
-    std::memcpy(m_byte_buffer.data() + m_byte_buffer.size() - sizeof(values_nb), &values_nb, sizeof(values_nb));
+        stream.file.seekp(static_cast<std::streamoff>(Header::SIZE + stream.size));
+        stream.file.write(reinterpret_cast<const char *>(footer_hash.data()),
+                          static_cast<std::streamsize>(footer_hash.size()));
+        GBKF_STATS_ADD(m_stats, bytes_written, footer_hash.size());
+    }
+
+    const bool failed = stream.file.fail();
+    stream.file.close();
+
+    if (failed) {
+        throw std::runtime_error("Cannot write the file");
+    }
+
+    // The appended records can be smaller than the index block and the footer they replaced
+    const uint64_t file_size = Header::SIZE + stream.size + (add_footer ? FOOTER_SIZE : 0);
+    if (stream.appended && file_size < stream.appended_file_size) {
+        std::filesystem::resize_file(m_stream_path, file_size);
+    }
 }
 
-std::vector<uint8_t> GBKFCoreWriter::formatKey(const std::string &key) {
-    std::string normalized_key = normalizeString(key);
-    return {normalized_key.begin(), normalized_key.end()};
+std::future<void> GBKFCoreWriter::closeAsync(const bool auto_update, const bool add_footer) {
+    return std::async(std::launch::async, [this, auto_update, add_footer]() {
+        close(auto_update, add_footer);
+    });
 }
 
-std::vector<uint8_t> GBKFCoreWriter::formatUInt16(const uint16_t value) {
-    std::vector<uint8_t> out(2);
-    std::memcpy(out.data(), &value, 2);
-    return out;
+void GBKFCoreWriter::openStream() {
+    m_stream = std::make_unique<Stream>();
+    m_stream->stats = m_stats;
+
+    m_stream->file.open(m_stream_path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!m_stream->file) {
+        throw std::runtime_error("Cannot open file");
+    }
+
+    // Reserve the header, it is written when the stream is closed.
+    m_stream->file.write(reinterpret_cast<const char *>(m_byte_buffer.data()), Header::SIZE);
+
+    if (m_stream_async_buffers_nb > 0) {
+        m_stream->async_buffers_nb = m_stream_async_buffers_nb;
+        m_stream->thread = std::thread(&Stream::runWriter, m_stream.get());
+    }
 }
 
-std::vector<uint8_t> GBKFCoreWriter::formatUInt32(const uint32_t value) {
-    std::vector<uint8_t> out(4);
-    std::memcpy(out.data(), &value, 4);
-    return out;
+void GBKFCoreWriter::openAppendStream() {
+    uint64_t records_end = Header::SIZE;
+    uint64_t file_size;
+
+    {
+        // The footer is verified once the end of the records is known, to skip the files without footer
+        const GBKFCoreReader reader(m_stream_path, ShaVerification::DEFERRED);
+        file_size = reader.m_bytes_size;
+
+        std::memcpy(m_byte_buffer.data(), reader.m_bytes_data, Header::SIZE);
+        m_keys_size = reader.getKeysSize();
+
+        if (reader.hasIndexBlock()) {
+            // The entries are kept, so the new index block also covers the existing records
+            m_index_block = true;
+            records_end = reader.m_index_entries_pos;
+
+            const uint64_t entry_size = m_keys_size + IndexBlock::ENTRY_SIZE_WITHOUT_KEY;
+            m_index_entries.reserve(reader.getKeyedValuesNb());
+
+            for (uint32_t entry_nb = 0; entry_nb < reader.getKeyedValuesNb(); ++entry_nb) {
+                const uint8_t *entry = reader.m_bytes_data + reader.m_index_entries_pos + entry_nb * entry_size;
+                const auto *key = reinterpret_cast<const char *>(entry);
+
+                IndexEntry index_entry{nullptr, 0, 0, 0};
+                std::memcpy(&index_entry.instance_id, entry + m_keys_size, 4);
+                std::memcpy(&index_entry.offset, entry + m_keys_size + 4, 8);
+                std::memcpy(&index_entry.length, entry + m_keys_size + 4 + 8, 8);
+                m_index_entries.push_back(index_entry);
+
+                registerKeyedValues(std::string(key, std::find(key, key + m_keys_size, '\0')));
+            }
+        } else {
+            // Only the record headers are read, to skip the values. The keys are kept like with the index block,
+            // so the keys size can not be changed.
+            for (uint32_t record_nb = 0; record_nb < reader.getKeyedValuesNb(); ++record_nb) {
+                const KeyedRecord record = reader.readKeyedRecord(records_end);
+                records_end = record.end_pos;
+                registerKeyedValues(std::string(record.key));
+            }
+        }
+
+        // The records (or the index block) end the data of a file without footer
+        const uint64_t data_end = reader.hasIndexBlock()
+                                      ? reader.m_index_buckets_pos +
+                                        static_cast<uint64_t>(reader.m_index_buckets_nb) * IndexBlock::BUCKET_SIZE +
+                                        IndexBlock::TRAILER_SIZE
+                                      : records_end;
+        if (file_size != data_end && !reader.verifiesSha()) {
+            throw std::runtime_error("The footer of the file to append to does not match its data");
+        }
+    }
+
+    m_buffer_offset = records_end - Header::SIZE;
+
+    m_stream = std::make_unique<Stream>();
+    m_stream->stats = m_stats;
+    m_stream->size = records_end - Header::SIZE;
+    m_stream->appended = true;
+    m_stream->appended_file_size = file_size;
+
+    m_stream->file.open(m_stream_path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!m_stream->file) {
+        throw std::runtime_error("Cannot open file");
+    }
+
+    // The new records replace the index block and the footer
+    m_stream->file.seekp(static_cast<std::streamoff>(records_end));
+    if (!m_stream->file) {
+        throw std::runtime_error("Cannot open file");
+    }
+
+    if (m_stream_async_buffers_nb > 0) {
+        m_stream->async_buffers_nb = m_stream_async_buffers_nb;
+        m_stream->thread = std::thread(&Stream::runWriter, m_stream.get());
+    }
+}
+
+void GBKFCoreWriter::flushStream() {
+    const uint64_t records_size = m_byte_buffer.size() - Header::SIZE;
+    Stream &stream = *m_stream;
+
+    if (stream.sha_header.empty()) {
+        // The hash starts with the header as it is on the first flush. If the header changes later on,
+        // close() can not use this hash (set the keyed-values number up-front to avoid it).
+        stream.sha_header.assign(m_byte_buffer.begin(), m_byte_buffer.begin() + Header::SIZE);
+    }
+
+    if (records_size == 0) {
+        return;
+    }
+
+    if (m_stream_async_buffers_nb == 0) {
+        stream.writeRecords(m_byte_buffer.data() + Header::SIZE, records_size);
+        m_byte_buffer.resize(Header::SIZE);
+        m_buffer_offset += records_size;
+        return;
+    }
+
+    // Hand the full buffer to the background thread, and continue with a free one
+    std::unique_lock<std::mutex> lock(stream.mutex);
+    stream.condition.wait(lock, [&stream]() {
+        return stream.pending_buffers.size() < stream.async_buffers_nb || stream.error;
+    });
+
+    if (stream.error) {
+        std::rethrow_exception(stream.error);
+    }
+
+    std::vector<uint8_t> buffer;
+    if (!stream.free_buffers.empty()) {
+        buffer = std::move(stream.free_buffers.back());
+        stream.free_buffers.pop_back();
+    }
+    buffer.reserve(Header::SIZE + m_stream_buffer_size);
+    buffer.assign(m_byte_buffer.begin(), m_byte_buffer.begin() + Header::SIZE);
+
+    std::swap(buffer, m_byte_buffer);
+    stream.pending_buffers.push_back(std::move(buffer));
+    m_buffer_offset += records_size;
+
+    lock.unlock();
+    stream.condition.notify_all();
+}
+
+void GBKFCoreWriter::updateBufferSha(const uint64_t end_pos) {
+    GBKF_STATS_TIMER(m_stats, hash_ns);
+
+    // The header is hashed first, so any change of it requires to hash everything again.
+    if (m_buffer_sha_header.empty() ||
+        !std::equal(m_buffer_sha_header.begin(), m_buffer_sha_header.end(), m_byte_buffer.begin())) {
+        m_buffer_sha = Sha256();
+        m_buffer_sha_size = 0;
+        m_buffer_sha_header.assign(m_byte_buffer.begin(), m_byte_buffer.begin() + Header::SIZE);
+    }
+
+    if (end_pos > m_buffer_sha_size) {
+        m_buffer_sha.update(m_byte_buffer.data() + m_buffer_sha_size, end_pos - m_buffer_sha_size);
+        m_buffer_sha_size = end_pos;
+    }
+}
+
+std::vector<uint8_t> GBKFCoreWriter::digestBuffer(const std::vector<uint8_t> &index_block) const {
+    if (index_block.empty()) {
+        return m_buffer_sha.digest();
+    }
+
+    // The index is rebuilt on each call, so it is kept out of the incremental hash
+    Sha256 sha256 = m_buffer_sha;
+    GBKF_STATS_TIMER(m_stats, hash_ns);
+    sha256.update(index_block.data(), index_block.size());
+    return sha256.digest();
+}
+
+std::vector<uint8_t> GBKFCoreWriter::buildIndexBlock(const uint64_t index_start) const {
+    if (!m_index_block) {
+        return {};
+    }
+
+    if (m_index_entries.size() >= (uint64_t(1) << 31)) {
+        throw std::runtime_error("Too many keyed-values for the index block");
+    }
+
+    const auto entries_nb = static_cast<uint32_t>(m_index_entries.size());
+    const uint32_t buckets_nb = IndexBlock::bucketsNb(entries_nb);
+
+    std::vector<uint8_t> index_block(IndexBlock::size(m_keys_size, entries_nb));
+    std::vector<uint32_t> buckets(buckets_nb, 0);
+
+    uint8_t *destination = index_block.data();
+    for (uint32_t entry_nb = 0; entry_nb < entries_nb; ++entry_nb) {
+        const IndexEntry &entry = m_index_entries[entry_nb];
+
+        // The key as the readers see it, up to the first null
+        std::string_view key = normalizeString(*entry.key);
+        key = key.substr(0, std::min<size_t>(key.find('\0'), m_keys_size));
+
+        std::copy(key.begin(), key.end(), destination);
+        destination = writeValue(destination + m_keys_size, entry.instance_id);
+        destination = writeValue(destination, entry.offset);
+        destination = writeValue(destination, entry.length);
+
+        uint64_t bucket_nb = IndexBlock::hash(key, entry.instance_id) & (buckets_nb - 1);
+        while (buckets[bucket_nb] != 0) {
+            bucket_nb = (bucket_nb + 1) & (buckets_nb - 1);
+        }
+        buckets[bucket_nb] = entry_nb + 1;
+    }
+
+    if (buckets_nb > 0) {
+        std::memcpy(destination, buckets.data(), buckets_nb * IndexBlock::BUCKET_SIZE);
+        destination += buckets_nb * IndexBlock::BUCKET_SIZE;
+    }
+
+    destination = writeValue(destination, index_start);
+    destination = writeValue(destination, entries_nb);
+    destination = writeValue(destination, buckets_nb);
+    destination = writeValue(destination, IndexBlock::VERSION);
+    std::memcpy(destination, IndexBlock::KEYWORD, IndexBlock::KEYWORD_SIZE);
+
+    return index_block;
+}
+
+void GBKFCoreWriter::compressRecord() {
+    const uint64_t values_size = m_byte_buffer.size() - m_record_values_pos;
+
+    if (m_compression == Compression::NONE || values_size < CompressedValues::MIN_VALUES_SIZE) {
+        return;
+    }
+
+    // The value type is before the values number
+    const uint64_t type_pos = m_record_values_pos - 5;
+    const uint8_t value_size = Delta::integerValueSize(static_cast<ValueType>(m_byte_buffer[type_pos]));
+    if (m_compression == Compression::DELTA && value_size == 0) {
+        return;
+    }
+
+    const uint64_t chunks_nb = (values_size + m_compression_chunk_size - 1) / m_compression_chunk_size;
+    if (chunks_nb > UINT32_MAX) {
+        return;
+    }
+
+    std::vector<uint8_t> compressed(CompressedValues::HEADER_SIZE + chunks_nb * 4);
+
+    for (uint64_t chunk_nb = 0; chunk_nb < chunks_nb; ++chunk_nb) {
+        const uint64_t chunk_pos = chunk_nb * m_compression_chunk_size;
+        const auto chunk_size = static_cast<uint32_t>(std::min<uint64_t>(m_compression_chunk_size,
+                                                                         values_size - chunk_pos));
+
+        const uint64_t compressed_pos = compressed.size();
+        compressed.resize(compressed_pos + Codecs::compressBound(m_compression, chunk_size, value_size));
+
+        const uint64_t compressed_chunk_size = Codecs::compress(m_compression,
+                                                                m_byte_buffer.data() + m_record_values_pos + chunk_pos,
+                                                                chunk_size,
+                                                                compressed.data() + compressed_pos,
+                                                                compressed.size() - compressed_pos,
+                                                                m_compression_level,
+                                                                value_size);
+
+        compressed.resize(compressed_pos + compressed_chunk_size);
+        writeValue(compressed.data() + CompressedValues::HEADER_SIZE + chunk_nb * 4,
+                   static_cast<uint32_t>(compressed_chunk_size));
+
+        // Not worth it, the values stay as they are
+        if (compressed.size() >= values_size) {
+            return;
+        }
+    }
+
+    uint8_t *destination = writeValue(compressed.data(), static_cast<uint8_t>(m_compression));
+    destination = writeValue(destination, values_size);
+    destination = writeValue(destination, static_cast<uint64_t>(compressed.size() - CompressedValues::HEADER_SIZE));
+    destination = writeValue(destination, m_compression_chunk_size);
+    writeValue(destination, static_cast<uint32_t>(chunks_nb));
+
+    m_byte_buffer.resize(m_record_values_pos);
+    m_byte_buffer.insert(m_byte_buffer.end(), compressed.begin(), compressed.end());
+
+    m_byte_buffer[type_pos] |= CompressedValues::TYPE_FLAG;
+
+    if (m_index_block) {
+        m_index_entries.back().length -= values_size - compressed.size();
+    }
+}
+
+void GBKFCoreWriter::registerKeyedValues(const std::string &key) {
+    m_keyed_values_nb++;
+
+    const auto inserted_key = m_keys.insert(key);
+    if (inserted_key.second) {
+        if (m_keys.size() == 1) {
+            m_keys_min_length = key.length();
+            m_keys_max_length = key.length();
+        } else {
+            m_keys_min_length = std::min(m_keys_min_length, key.length());
+            m_keys_max_length = std::max(m_keys_max_length, key.length());
+        }
+    }
+
+    // The keys of the set keep their address
+    if (m_index_block) {
+        m_index_entries.back().key = &*inserted_key.first;
+    }
+
+    if (isStreaming() && m_byte_buffer.size() - Header::SIZE >= m_stream_buffer_size) {
+        flushStream();
+    }
+}
+
+std::string_view GBKFCoreWriter::normalizeString(const std::string_view input) {
+    // Trim trailing nulls
+    const auto end = input.find_last_not_of('\0');
+    if (end == std::string_view::npos) {
+        return {};
+    }
+    return input.substr(0, end + 1);
+}
+
+uint8_t *GBKFCoreWriter::writeKeyedValuesHeader(const std::string &key,
+                                                const uint32_t instance_id,
+                                                const uint32_t values_nb,
+                                                ValueType value_type,
+                                                const uint64_t values_size) {
+
+    const std::string_view normalized_key = normalizeString(key);
+
+    // Resize once for the whole keyed-values
+    [[maybe_unused]] const size_t previous_capacity = m_byte_buffer.capacity();
+    const uint64_t start_pos = m_byte_buffer.size();
+    m_byte_buffer.resize(start_pos + normalized_key.size() + KEYED_VALUES_HEADER_SIZE + values_size);
+    if (m_index_block) {
+        const uint64_t record_size = m_byte_buffer.size() - start_pos;
+        m_index_entries.push_back({nullptr, instance_id, m_buffer_offset + start_pos, record_size});
+    }
+    GBKF_STATS_RECORD(m_stats, static_cast<uint8_t>(value_type),
+                      m_byte_buffer.capacity() != previous_capacity ? 1 : 0);
+
+    m_record_values_pos = start_pos + normalized_key.size() + KEYED_VALUES_HEADER_SIZE;
+
+    // Add the key
+    uint8_t *destination = std::copy(normalized_key.begin(), normalized_key.end(), m_byte_buffer.data() + start_pos);
+
+    // Add the instance_id, the value_type and the values_nb
+    destination = writeValue(destination, instance_id);
+    destination = writeValue(destination, static_cast<uint8_t>(value_type));
+    return writeValue(destination, values_nb);
 }
 
 void GBKFCoreWriter::setUInt8(const uint8_t value,
@@ -17,10 +17,19 @@
 #include <limits>
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <memory_resource>
 
 #include "GBKF/GBKFCore.hxx"
 #include "GBKF/GBKFCoreReader.hxx"
 #include "GBKF/GBKFCoreWriter.hxx"
+#include "GBKF/GBKFCoreStreamReader.hxx"
+#include "GBKF/GBKFCoreSha256.hxx"
+#include "GBKF/GBKFCoreSchema.hxx"
+#include "GBKF/GBKFCoreCompression.hxx"
+#include "GBKF/picosha2.hxx"
 
 void testHeader() {
     std::string path = "test_core_header.gbkf";
@@ -380,6 +389,1656 @@ void testStringBufferSize5() {
     std::cout << "test OK > testStringBufferSize5\n";
 }
 
+void testReaderSources() {
+
+    const std::string path = "test_core_sources.gbkf";
+    const std::vector<double> input_values = {1.5, -2.25, 1000.125};
+
+    GBKFCoreWriter writer;
+    writer.setSpecificationId(42);
+    writer.addKeyedValuesFloat64("F", 7, input_values);
+    writer.write(path);
+
+    std::vector<uint8_t> buffer = writer.getBytesBuffer();
+
+    const GBKFCoreReader file_reader(path);
+    const GBKFCoreReader copy_reader(buffer);
+    const GBKFCoreReader view_reader(buffer.data(), buffer.size());
+    const GBKFCoreReader moved_reader(std::move(buffer));
+
+    for (const GBKFCoreReader *reader: {&file_reader, &copy_reader, &view_reader, &moved_reader}) {
+        assert(reader->getSpecificationID() == 42);
+        assert(reader->verifiesSha());
+
+        auto map = reader->getKeyedEntries();
+        assert(map["F"][0].instance_id == 7);
+        assert(map["F"][0].getValues<double>() == input_values);
+    }
+
+    std::filesystem::remove(path);
+
+    std::cout << "test OK > testReaderSources\n";
+}
+
+void testIndexedAccess() {
+
+    GBKFCoreWriter writer;
+    writer.setKeysSize(2);
+    writer.addKeyedValuesUInt32("AA", 1, {1, 2, 3});
+    writer.addKeyedValuesStringUTF8("BB", 1, {"x", "yy"}, 0);
+    writer.addKeyedValuesBoolean("CC", 1, {true, false, true});
+    writer.addKeyedValuesUInt32("AA", 2, {4, 5});
+    writer.addKeyedValuesStringUTF8("BB", 2, {"zzz"}, 4);
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+
+    const auto &records = reader.getKeyedRecords();
+    assert(records.size() == 5);
+    assert(records[0].key == "AA" && records[0].type == GBKFCore::ValueType::UINT32 && records[0].values_nb == 3);
+    assert(records[3].key == "AA" && records[3].instance_id == 2);
+    for (size_t i = 1; i < records.size(); ++i) {
+        assert(records[i - 1].end_pos <= records[i].values_pos);
+    }
+
+    // The index is cached
+    assert(&reader.getKeyedRecords() == &records);
+
+    auto entry = reader.getKeyedEntry("AA", 2);
+    assert(entry.getValues<uint32_t>() == std::vector<uint32_t>({4, 5}));
+
+    entry = reader.getKeyedEntry("BB", 2);
+    assert(entry.getValues<std::string>() == std::vector<std::string>({"zzz"}));
+
+    const auto entries = reader.findEntries("AA");
+    assert(entries.size() == 2);
+    assert(entries[0].instance_id == 1 && entries[1].instance_id == 2);
+
+    assert(reader.findEntries("ZZ").empty());
+    assert(reader.hasKeyedEntry("CC", 1));
+    assert(!reader.hasKeyedEntry("CC", 2));
+
+    bool thrown = false;
+    try {
+        (void) reader.getKeyedEntry("CC", 2);
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "test OK > testIndexedAccess\n";
+}
+
+void testShaVerification() {
+
+    GBKFCoreWriter writer;
+    writer.setSpecificationId(3);
+    writer.addKeyedValuesInt16("I", 1, {1, -2, 3});
+
+    std::vector<uint8_t> buffer = writer.getBytesBuffer();
+    std::vector<uint8_t> corrupted_buffer = buffer;
+    corrupted_buffer[GBKFCore::Header::SIZE + 3] ^= 0xFF;
+
+    for (const auto mode: {GBKFCore::ShaVerification::IMMEDIATE,
+                           GBKFCore::ShaVerification::DEFERRED,
+                           GBKFCore::ShaVerification::BACKGROUND}) {
+
+        const GBKFCoreReader reader(buffer, mode);
+        assert(reader.getSpecificationID() == 3);
+        assert(reader.getKeyedEntry("I", 1).getValues<int16_t>() == std::vector<int16_t>({1, -2, 3}));
+        assert(reader.verifiesSha());
+        assert(reader.verifiesSha());
+
+        const GBKFCoreReader reader_copy = reader;
+        assert(reader_copy.verifiesSha());
+
+        const GBKFCoreReader corrupted_reader(corrupted_buffer, mode);
+        assert(!corrupted_reader.verifiesSha());
+    }
+
+    std::cout << "test OK > testShaVerification\n";
+}
+
+void testSha256() {
+
+    const std::string abc = "abc";
+    const std::vector<uint8_t> abc_expected = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    };
+    assert(GBKFCore::Sha256::hash(reinterpret_cast<const uint8_t *>(abc.data()), abc.size()) == abc_expected);
+
+    GBKFCore::Sha256 abc_portable(false);
+    abc_portable.update(reinterpret_cast<const uint8_t *>(abc.data()), abc.size());
+    assert(abc_portable.digest() == abc_expected);
+
+    // Lengths around the block and padding boundaries, fed by irregular chunks
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+
+    for (const size_t size: {0, 1, 55, 56, 63, 64, 65, 119, 128, 1000}) {
+        std::vector<uint8_t> expected(GBKFCore::FOOTER_SIZE);
+        picosha2::hash256(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(size), expected.begin(), expected.end());
+
+        // The default path (with the SHA CPU instructions when available) and the portable one
+        for (const bool allow_hardware: {true, false}) {
+            GBKFCore::Sha256 sha256(allow_hardware);
+            size_t pos = 0;
+            for (size_t chunk = 1; pos < size; chunk = chunk * 3 + 1) {
+                const size_t chunk_size = std::min(chunk, size - pos);
+                sha256.update(data.data() + pos, chunk_size);
+                pos += chunk_size;
+            }
+
+            assert(sha256.digest() == expected);
+        }
+        assert(GBKFCore::Sha256::hash(data.data(), size) == expected);
+    }
+
+    std::cout << "test OK > testSha256\n";
+}
+
+void testStreamingWriter() {
+
+    const std::string memory_path = "test_core_stream_memory.gbkf";
+    const std::string stream_path = "test_core_stream.gbkf";
+    const std::string preset_path = "test_core_stream_preset.gbkf";
+
+    std::vector<double> input_values(100);
+    for (size_t i = 0; i < input_values.size(); ++i) {
+        input_values[i] = static_cast<double>(i) * 1.5;
+    }
+
+    GBKFCoreWriter memory_writer;
+    {
+        // A small buffer, so the records are flushed many times
+        GBKFCoreWriter stream_writer(stream_path, 64);
+
+        for (auto *writer: {&memory_writer, &stream_writer}) {
+            writer->setSpecificationId(9);
+            for (uint32_t i = 0; i < 50; ++i) {
+                writer->addKeyedValuesFloat64("F", i, input_values);
+                writer->addKeyedValuesStringUTF8("S", i, {"a", std::to_string(i)}, 0);
+            }
+        }
+
+        assert(stream_writer.isStreaming());
+        stream_writer.close();
+    }
+    memory_writer.write(memory_path);
+
+    // The streamed file is identical to the in-memory one
+    const GBKFCoreReader stream_reader(stream_path);
+    const GBKFCoreReader memory_reader(memory_path);
+    assert(stream_reader.verifiesSha());
+    assert(stream_reader.getKeyedValuesNb() == 100);
+    assert(stream_reader.getKeyedEntry("F", 49).getValues<double>() == input_values);
+    assert(memory_writer.getBytesBuffer() ==
+           std::vector<uint8_t>(std::istreambuf_iterator<char>(std::ifstream(stream_path, std::ios::binary).rdbuf()),
+                                std::istreambuf_iterator<char>()));
+
+    // Keyed-values number set up-front: the hash is computed while flushing
+    {
+        GBKFCoreWriter stream_writer(preset_path, 64);
+        stream_writer.setKeyedValuesNb(20);
+        for (uint32_t i = 0; i < 20; ++i) {
+            stream_writer.addKeyedValuesFloat64("F", i, input_values);
+        }
+        stream_writer.close(false);
+    }
+
+    const GBKFCoreReader preset_reader(preset_path);
+    assert(preset_reader.verifiesSha());
+    assert(preset_reader.getKeyedEntries()["F"].size() == 20);
+
+    // Assigning over an open stream completes its file first
+    {
+        GBKFCoreWriter stream_writer(stream_path, 64);
+        for (uint32_t i = 0; i < 5; ++i) {
+            stream_writer.addKeyedValuesFloat64("F", i, input_values);
+        }
+
+        GBKFCoreWriter preset_writer(preset_path, 64);
+        preset_writer.addKeyedValuesFloat64("P", 0, input_values);
+        stream_writer = std::move(preset_writer);
+
+        const GBKFCoreReader assigned_reader(stream_path);
+        assert(assigned_reader.verifiesSha());
+        assert(assigned_reader.getKeyedValuesNb() == 5);
+        assert(assigned_reader.getKeyedEntry("F", 4).getValues<double>() == input_values);
+
+        stream_writer.addKeyedValuesFloat64("P", 1, input_values);
+        stream_writer.close();
+    }
+
+    const GBKFCoreReader moved_reader(preset_path);
+    assert(moved_reader.verifiesSha());
+    assert(moved_reader.getKeyedValuesNb() == 2);
+
+    std::filesystem::remove(memory_path);
+    std::filesystem::remove(stream_path);
+    std::filesystem::remove(preset_path);
+
+    std::cout << "test OK > testStreamingWriter\n";
+}
+
+void testStreamReader() {
+
+    const std::vector<uint16_t> input_values = {1, 2, 3, 65535};
+    const std::vector<std::string> input_strings = {"A", "éé", "€€€"};
+
+    GBKFCoreWriter writer;
+    writer.setSpecificationId(5);
+    writer.addKeyedValuesUInt16("U", 1, input_values);
+    writer.addKeyedValuesStringUTF8("S", 2, input_strings, 0);
+    writer.addKeyedValuesStringUTF8("F", 3, input_strings, 10);
+    writer.addKeyedValuesBoolean("B", 4, {true, false, true});
+    writer.addKeyedValuesUInt16("U", 5, input_values);
+
+    const std::vector<uint8_t> buffer = writer.getBytesBuffer();
+    std::istringstream stream(std::string(buffer.begin(), buffer.end()));
+
+    GBKFCoreStreamReader reader(stream);
+    assert(reader.getSpecificationID() == 5);
+    assert(reader.getKeyedValuesNb() == 5);
+
+    uint32_t records_nb = 0;
+    while (reader.nextRecord()) {
+        const GBKFCore::KeyedRecord &record = reader.getRecord();
+        ++records_nb;
+
+        if (record.key == "U" && record.instance_id == 1) {
+            assert(reader.readEntry().getValues<uint16_t>() == input_values);
+        } else if (record.key == "S" || record.key == "F") {
+            assert(reader.readEntry().getValues<std::string>() == input_strings);
+        }
+        // The other records are skipped
+    }
+
+    assert(records_nb == 5);
+    assert(reader.verifiesSha());
+    assert(!reader.nextRecord());
+
+    // Corrupted data
+    std::vector<uint8_t> corrupted_buffer = buffer;
+    corrupted_buffer[GBKFCore::Header::SIZE + 12] ^= 0xFF;
+    std::istringstream corrupted_stream(std::string(corrupted_buffer.begin(), corrupted_buffer.end()));
+
+    GBKFCoreStreamReader corrupted_reader(corrupted_stream);
+    while (corrupted_reader.nextRecord()) {
+    }
+    assert(!corrupted_reader.verifiesSha());
+
+    std::cout << "test OK > testStreamReader\n";
+}
+
+void testValuesView() {
+
+    const std::vector<float> input_floats = {1.5f, -2.5f, 3.25f, 1000.f};
+    const std::vector<uint8_t> input_blob = {1, 2, 3};
+
+    GBKFCoreWriter writer;
+    writer.addKeyedValuesUInt8("U", 1, {7});  // Shifts the alignment of the next record
+    writer.addKeyedValuesFloat32("F", 1, input_floats);
+    writer.addKeyedValuesBlob("B", 1, input_blob);
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+
+    const auto floats_view = reader.getValuesView<float>("F", 1);
+    assert(floats_view.size() == input_floats.size());
+    assert(floats_view.toVector() == input_floats);
+
+    float sum = 0;
+    for (const float value: floats_view) {
+        sum += value;
+    }
+    assert(sum == 1.5f - 2.5f + 3.25f + 1000.f);
+    assert(floats_view[2] == 3.25f);
+
+    if (floats_view.isAligned()) {
+        assert(floats_view.alignedData()[3] == 1000.f);
+    }
+
+    assert(reader.getValuesView<uint8_t>("B", 1).toVector() == input_blob);
+
+    bool thrown = false;
+    try {
+        (void) reader.getValuesView<double>("F", 1);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "test OK > testValuesView\n";
+}
+
+void testParallelDecode() {
+
+    GBKFCoreWriter writer;
+    for (uint32_t i = 1; i <= 50; ++i) {
+        writer.addKeyedValuesUInt32("A", i, std::vector<uint32_t>(i * 10, i));
+        writer.addKeyedValuesStringUTF8("B", i, {std::to_string(i)}, 0);
+    }
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+    auto serial_entries = reader.getKeyedEntries();
+
+    for (const unsigned int threads_nb: {0u, 1u, 3u, 200u}) {
+        auto parallel_entries = reader.getKeyedEntries(threads_nb);
+        assert(parallel_entries.size() == serial_entries.size());
+
+        for (uint32_t i = 0; i < 50; ++i) {
+            assert(parallel_entries["A"][i].instance_id == i + 1);
+            assert(parallel_entries["A"][i].getValues<uint32_t>() == serial_entries["A"][i].getValues<uint32_t>());
+            assert(parallel_entries["B"][i].getValues<std::string>() ==
+                   serial_entries["B"][i].getValues<std::string>());
+        }
+    }
+
+    std::cout << "test OK > testParallelDecode\n";
+}
+
+void testKeyedEntryValues() {
+
+    GBKFCore::KeyedEntry entry(GBKFCore::ValueType::INT16);
+    entry.addValue<int16_t>(-3);
+    entry.addValues<int16_t>({4, 5});
+    assert(entry.getValues<int16_t>() == std::vector<int16_t>({-3, 4, 5}));
+
+    // Copies do not share the values
+    GBKFCore::KeyedEntry entry_copy = entry;
+    entry_copy.addValue<int16_t>(6);
+    assert(entry.getValues<int16_t>().size() == 3);
+    assert(entry_copy.getValues<int16_t>().size() == 4);
+
+    const GBKFCore::KeyedEntry entry_moved = std::move(entry_copy);
+    assert(entry_moved.getValues<int16_t>().size() == 4);
+
+    // BLOB values are read as uint8_t, but no other type is
+    GBKFCore::KeyedEntry entry_blob(GBKFCore::ValueType::BLOB);
+    entry_blob.addValue<uint8_t>(1);
+    assert(entry_blob.getValues<uint8_t>().size() == 1);
+
+    GBKFCore::KeyedEntry entry_int8(GBKFCore::ValueType::INT8);
+    bool thrown = false;
+    try {
+        (void) entry_int8.getValues<uint8_t>();
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "test OK > testKeyedEntryValues\n";
+}
+
+void testMemoryResource() {
+
+    GBKFCoreWriter writer;
+    writer.addKeyedValuesUInt32("A", 1, {1, 2, 3});
+    writer.addKeyedValuesUInt32("A", 2, {4});
+    writer.addKeyedValuesStringUTF8("B", 1, {"a string longer than the small string buffer", "b"}, 0);
+    writer.addKeyedValuesBoolean("C", 1, {true, false, true});
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+    (void) reader.getKeyedRecords(); // The index is not part of the result
+
+    std::pmr::monotonic_buffer_resource arena;
+
+    // Any allocation made outside the arena would throw
+    std::pmr::memory_resource *default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    auto keyed_entries = reader.getKeyedEntries(&arena);
+    std::pmr::set_default_resource(default_resource);
+
+    assert(keyed_entries.size() == 3);
+    assert(keyed_entries["A"].size() == 2);
+    assert(keyed_entries["A"][1].instance_id == 2);
+    assert(keyed_entries["A"][0].getValues<uint32_t>() == std::pmr::vector<uint32_t>({1, 2, 3}));
+    assert(keyed_entries["A"][0].get_allocator().resource() == &arena);
+
+    const auto &strings = keyed_entries["B"][0].getValues<std::pmr::string>();
+    assert(strings.size() == 2 && strings[0] == "a string longer than the small string buffer" && strings[1] == "b");
+    assert(strings[0].get_allocator().resource() == &arena);
+
+    assert(keyed_entries["C"][0].getValues<bool>() == std::pmr::vector<bool>({true, false, true}));
+
+    std::cout << "test OK > testMemoryResource\n";
+}
+
+void testStringViews() {
+
+    GBKFCoreWriter writer;
+    writer.addKeyedValuesStringUTF8("D", 1, {"dynamic", "", "strings"}, 0);
+    writer.addKeyedValuesStringUTF8("F", 1, {"fixed", "ab"}, 8);
+    writer.addKeyedValuesUInt8("U", 1, {1});
+
+    const std::vector<uint8_t> bytes = writer.getBytesBuffer();
+    const GBKFCoreReader reader(bytes);
+
+    const auto dynamic_views = reader.getStringViews("D", 1);
+    assert(dynamic_views == std::vector<std::string_view>({"dynamic", "", "strings"}));
+
+    const auto fixed_views = reader.getStringViews("F", 1);
+    assert(fixed_views == std::vector<std::string_view>({"fixed", "ab"}));
+
+    bool thrown = false;
+    try {
+        (void) reader.getStringViews("U", 1);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::istringstream stream(std::string(bytes.begin(), bytes.end()));
+    GBKFCoreStreamReader stream_reader(stream);
+    assert(stream_reader.nextRecord());
+    assert(stream_reader.readStringViews() == dynamic_views);
+    while (stream_reader.nextRecord()) {
+    }
+    assert(stream_reader.verifiesSha());
+
+    std::cout << "test OK > testStringViews\n";
+}
+
+void testKeysRegistry() {
+
+    GBKFCoreWriter writer;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        writer.addKeyedValuesUInt8("K" + std::to_string(100 + i % 100), i, {1});
+    }
+
+    // All the keys have 4 characters
+    writer.setKeysSize(4);
+
+    bool thrown = false;
+    try {
+        writer.setKeysSize(3);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    writer.addKeyedValuesUInt8("LONGER", 1, {1});
+    thrown = false;
+    try {
+        writer.setKeysSize(4);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    writer.reset();
+    writer.setKeysSize(6);
+
+    std::cout << "test OK > testKeysRegistry\n";
+}
+
+void testStringsBounds() {
+
+    GBKFCoreWriter writer;
+
+    bool thrown = false;
+    try {
+        writer.addKeyedValuesStringUTF8("A", 1, {std::string(UINT16_MAX + 1, 'a')}, 0);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        writer.addKeyedValuesStringUTF8("A", 1, {"abc"}, 2);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // The rejected records are not written, trailing nulls are not part of the strings
+    writer.addKeyedValuesStringUTF8("A", 1, {std::string("ab\0\0", 4), std::string(UINT16_MAX, 'b')}, 0);
+    writer.addKeyedValuesStringUTF8("A", 2, {std::string("ab\0\0", 4)}, 2);
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+    assert(reader.getKeyedValuesNb() == 2);
+    assert(reader.getStringViews("A", 1)[0] == "ab");
+    assert(reader.getStringViews("A", 1)[1].size() == UINT16_MAX);
+    assert(reader.getStringViews("A", 2)[0] == "ab");
+
+    std::cout << "test OK > testStringsBounds\n";
+}
+
+void testContiguousValues() {
+
+    const int16_t input_int16[] = {-1, 2, -3};
+    const double input_float64[] = {0.5, 1e300};
+    const uint8_t input_blob[] = {9, 8, 7, 6};
+
+    GBKFCoreWriter writer;
+    writer.reserveRecords(3, 16);
+    writer.reserve(1024);
+    writer.addKeyedValuesInt16("A", 1, input_int16, 3);
+    writer.addKeyedValuesFloat64("B", 1, input_float64, 2);
+    writer.addKeyedValuesBlob("C", 1, input_blob, 4);
+    writer.addKeyedValuesUInt32("D", 1, nullptr, 0);
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+    assert(reader.verifiesSha());
+    assert(reader.getKeyedEntry("A", 1).getValues<int16_t>() == std::vector<int16_t>({-1, 2, -3}));
+    assert(reader.getKeyedEntry("B", 1).getValues<double>() == std::vector<double>({0.5, 1e300}));
+    assert(reader.getKeyedEntry("C", 1).getValues<uint8_t>() == std::vector<uint8_t>({9, 8, 7, 6}));
+    assert(reader.getKeyedEntry("D", 1).getValues<uint32_t>().empty());
+
+    std::cout << "test OK > testContiguousValues\n";
+}
+
+void testTakeBytesBuffer() {
+
+    GBKFCoreWriter writer;
+    writer.setSpecificationId(7);
+    writer.reserveRecords(2, 4 * sizeof(uint32_t));
+    writer.addKeyedValuesUInt32("A", 1, {1, 2, 3, 4});
+    writer.addKeyedValuesUInt32("A", 2, {5, 6, 7, 8});
+
+    const std::vector<uint8_t> copied_bytes = writer.getBytesBuffer();
+
+    const std::string write_path = "test_core_take_bytes_buffer.gbkf";
+    writer.write(write_path);
+    std::ifstream file(write_path, std::ios::binary);
+    const std::vector<uint8_t> written_bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    assert(written_bytes == copied_bytes);
+    std::filesystem::remove(write_path);
+
+    // The buffer is moved out, with the footer
+    std::vector<uint8_t> taken_bytes = writer.takeBytesBuffer();
+    assert(taken_bytes == copied_bytes);
+
+    const GBKFCoreReader reader(std::move(taken_bytes));
+    assert(reader.verifiesSha());
+    assert(reader.getKeyedValuesNb() == 2);
+
+    // The writer is reset
+    const GBKFCoreReader reset_reader(writer.getBytesBuffer());
+    assert(reset_reader.getKeyedValuesNb() == 0);
+    assert(reset_reader.getSpecificationID() == 0);
+
+    // The index block and the footer fit in the reserved buffer
+    const uint64_t records_size = 3 * (2 + GBKFCore::KEYED_VALUES_HEADER_SIZE + 4 * sizeof(uint32_t));
+    for (const bool reserve_records: {true, false}) {
+        GBKFCoreWriter indexed_writer;
+        indexed_writer.setKeysSize(2);
+        indexed_writer.setIndexBlock(true);
+        uint64_t reserved_size = GBKFCore::Header::SIZE + records_size + GBKFCore::FOOTER_SIZE;
+        if (reserve_records) {
+            indexed_writer.reserveRecords(3, 4 * sizeof(uint32_t));
+            reserved_size += GBKFCore::IndexBlock::size(2, 3);
+        } else {
+            indexed_writer.reserve(records_size);
+            reserved_size += GBKFCore::IndexBlock::size(2, records_size / (2 + GBKFCore::KEYED_VALUES_HEADER_SIZE));
+        }
+        indexed_writer.addKeyedValuesUInt32("AB", 1, {1, 2, 3, 4});
+        indexed_writer.addKeyedValuesUInt32("AB", 2, {5, 6, 7, 8});
+        indexed_writer.addKeyedValuesUInt32("CD", 1, {9, 10, 11, 12});
+
+        const std::vector<uint8_t> indexed_bytes = indexed_writer.takeBytesBuffer();
+        assert(indexed_bytes.capacity() == reserved_size); // Not reallocated
+        assert(indexed_bytes.size() == GBKFCore::Header::SIZE + records_size + GBKFCore::IndexBlock::size(2, 3) +
+                                       GBKFCore::FOOTER_SIZE);
+
+        const GBKFCoreReader indexed_reader(indexed_bytes);
+        assert(indexed_reader.verifiesSha());
+        assert(indexed_reader.hasIndexBlock());
+        assert(indexed_reader.getKeyedEntry("CD", 1).getValues<uint32_t>()[3] == 12);
+    }
+
+    std::cout << "test OK > testTakeBytesBuffer\n";
+}
+
+void testIncrementalFooter() {
+
+    GBKFCoreWriter writer;
+    writer.setKeyedValuesNb(3);
+
+    writer.addKeyedValuesUInt64("A", 1, std::vector<uint64_t>(100, 1));
+    const std::vector<uint8_t> first_checkpoint = writer.getBytesBuffer(false);
+    assert(GBKFCoreReader(first_checkpoint).verifiesSha());
+
+    writer.addKeyedValuesUInt64("A", 2, std::vector<uint64_t>(100, 2));
+    const std::vector<uint8_t> second_checkpoint = writer.getBytesBuffer(false);
+    assert(GBKFCoreReader(second_checkpoint).verifiesSha());
+
+    // The header changes, so everything is hashed again
+    writer.addKeyedValuesUInt64("A", 3, std::vector<uint64_t>(100, 3));
+    writer.setSpecificationVersion(2);
+    const std::vector<uint8_t> third_checkpoint = writer.getBytesBuffer(false);
+    const GBKFCoreReader reader(third_checkpoint);
+    assert(reader.verifiesSha());
+    assert(reader.getSpecificationVersion() == 2);
+    assert(reader.getKeyedEntries().at("A").size() == 3);
+
+    const std::vector<uint8_t> with_auto_update = writer.getBytesBuffer();
+    assert(GBKFCoreReader(with_auto_update).verifiesSha());
+
+    std::cout << "test OK > testIncrementalFooter\n";
+}
+
+void testOpenMany() {
+
+    std::vector<std::string> paths;
+    for (uint32_t i = 0; i < 20; ++i) {
+        GBKFCoreWriter writer;
+        writer.setSpecificationId(i);
+        writer.addKeyedValuesUInt32("A", 1, std::vector<uint32_t>(i * 100, i));
+
+        paths.push_back("test_core_open_many_" + std::to_string(i) + ".gbkf");
+        writer.write(paths.back());
+    }
+    paths.emplace_back("test_core_open_many_missing.gbkf");
+
+    for (const unsigned int threads_nb: {0u, 1u, 4u}) {
+        auto readers = GBKFCoreReader::openMany(paths, GBKFCore::ShaVerification::IMMEDIATE, threads_nb);
+        assert(readers.size() == paths.size());
+
+        // Waited for in any order, the futures can be read several times
+        for (uint32_t i = 20; i-- > 0;) {
+            const GBKFCoreReader reader = readers[i].get();
+            assert(reader.verifiesSha());
+            assert(reader.getSpecificationID() == i);
+            assert(reader.getKeyedEntry("A", 1).getValues<uint32_t>().size() == i * 100);
+            assert(readers[i].get().getSpecificationID() == i);
+        }
+
+        bool thrown = false;
+        try {
+            (void) readers.back().get();
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    for (size_t i = 0; i < 20; ++i) {
+        std::filesystem::remove(paths[i]);
+    }
+
+    std::cout << "test OK > testOpenMany\n";
+}
+
+void testAsyncStreamingWriter() {
+
+    const std::string memory_path = "test_core_async_memory.gbkf";
+    const std::string stream_path = "test_core_async_stream.gbkf";
+    const std::string preset_path = "test_core_async_preset.gbkf";
+
+    std::vector<uint64_t> input_values(1000);
+    for (size_t i = 0; i < input_values.size(); ++i) {
+        input_values[i] = i * 7;
+    }
+
+    GBKFCoreWriter memory_writer;
+    {
+        // Small buffers and a short queue, so the producer waits for the background thread
+        GBKFCoreWriter stream_writer(stream_path, 256, 2);
+
+        for (auto *writer: {&memory_writer, &stream_writer}) {
+            for (uint32_t i = 0; i < 200; ++i) {
+                writer->addKeyedValuesUInt64("U", i, input_values);
+                writer->addKeyedValuesStringUTF8("S", i, {"async", std::to_string(i)}, 0);
+            }
+        }
+
+        stream_writer.closeAsync().get();
+    }
+    memory_writer.write(memory_path);
+
+    const GBKFCoreReader stream_reader(stream_path);
+    assert(stream_reader.verifiesSha());
+    assert(stream_reader.getKeyedValuesNb() == 400);
+    assert(stream_reader.getKeyedEntry("U", 199).getValues<uint64_t>() == input_values);
+    assert(memory_writer.getBytesBuffer() ==
+           std::vector<uint8_t>(std::istreambuf_iterator<char>(std::ifstream(stream_path, std::ios::binary).rdbuf()),
+                                std::istreambuf_iterator<char>()));
+
+    // Hash computed by the background thread
+    {
+        GBKFCoreWriter stream_writer(preset_path, 256, 3);
+        stream_writer.setKeyedValuesNb(100);
+        for (uint32_t i = 0; i < 100; ++i) {
+            stream_writer.addKeyedValuesUInt64("U", i, input_values);
+        }
+        stream_writer.close(false);
+    }
+
+    const GBKFCoreReader preset_reader(preset_path);
+    assert(preset_reader.verifiesSha());
+    assert(preset_reader.getKeyedEntries()["U"].size() == 100);
+
+    std::filesystem::remove(memory_path);
+    std::filesystem::remove(stream_path);
+    std::filesystem::remove(preset_path);
+
+    std::cout << "test OK > testAsyncStreamingWriter\n";
+}
+
+void testFilteredDecode() {
+
+    GBKFCoreWriter writer;
+    for (uint32_t i = 0; i < 10; ++i) {
+        writer.addKeyedValuesFloat64("F", i, {i * 0.5, i * 1.5});
+        writer.addKeyedValuesStringUTF8("S", i, {"s" + std::to_string(i)}, 0);
+        writer.addKeyedValuesStringUTF8("T", i, {"t", "u"}, 4);
+        writer.addKeyedValuesBoolean("B", i, std::vector<bool>(i + 3, true));
+        writer.addKeyedValuesUInt16("U", i, {static_cast<uint16_t>(i)});
+    }
+
+    const std::vector<uint8_t> bytes = writer.getBytesBuffer();
+
+    // Before and after the records were scanned and cached
+    for (const bool cached: {false, true}) {
+        const GBKFCoreReader reader(bytes);
+        if (cached) {
+            (void) reader.getKeyedRecords();
+        }
+
+        const auto all_entries = reader.getKeyedEntries();
+
+        GBKFCore::KeyedEntriesFilter filter;
+        assert(reader.getKeyedEntries(filter).size() == all_entries.size());
+
+        filter.keys = {"F", "B", "missing"};
+        auto entries = reader.getKeyedEntries(filter);
+        assert(entries.size() == 2);
+        assert(entries["F"].size() == 10);
+        assert(entries["F"][9].getValues<double>() == all_entries.at("F")[9].getValues<double>());
+        assert(entries["B"][2].getValues<bool>() == std::vector<bool>(5, true));
+
+        filter.instance_id_min = 3;
+        filter.instance_id_max = 5;
+        entries = reader.getKeyedEntries(filter);
+        assert(entries["F"].size() == 3);
+        assert(entries["F"][0].getValues<double>() == std::vector<double>({1.5, 4.5}));
+
+        filter = {};
+        filter.types_mask = GBKFCore::KeyedEntriesFilter::typeMask(GBKFCore::ValueType::STRING) |
+                            GBKFCore::KeyedEntriesFilter::typeMask(GBKFCore::ValueType::UINT16);
+        entries = reader.getKeyedEntries(filter);
+        assert(entries.size() == 3);
+        assert(entries["S"][4].getValues<std::string>() == std::vector<std::string>({"s4"}));
+        assert(entries["T"][0].getValues<std::string>() == std::vector<std::string>({"t", "u"}));
+        assert(entries["U"][7].getValues<uint16_t>() == std::vector<uint16_t>({7}));
+
+        filter = {};
+        filter.key_predicate = [](const std::string_view key) { return key != "F"; };
+        assert(reader.getKeyedEntries(filter).size() == 4);
+    }
+
+    std::cout << "test OK > testFilteredDecode\n";
+}
+
+void testStats() {
+
+    const std::string path = "test_core_stats.gbkf";
+
+    GBKFCoreWriter writer;
+    for (uint32_t i = 0; i < 10; ++i) {
+        writer.addKeyedValuesUInt32("U", i, std::vector<uint32_t>(100, i));
+        writer.addKeyedValuesStringUTF8("S", i, {"a", "b"}, 0);
+    }
+    writer.write(path);
+
+    const GBKFCore::Stats writer_stats = writer.getStats();
+
+    GBKFCoreReader reader(path);
+    const auto entries = reader.getKeyedEntries();
+    const GBKFCore::Stats reader_stats = reader.getStats();
+
+    if (!reader_stats.enabled) {
+        // Built without GBKF_STATS
+        assert(!writer_stats.enabled);
+        assert(reader_stats.records_nb == 0 && writer_stats.bytes_written == 0);
+
+    } else {
+        const auto type_nb = [](const GBKFCore::ValueType type) { return static_cast<uint8_t>(type); };
+
+        assert(writer_stats.records_nb == 20);
+        assert(writer_stats.records_nb_by_type[type_nb(GBKFCore::ValueType::STRING)] == 10);
+        assert(writer_stats.bytes_written == std::filesystem::file_size(path));
+        assert(writer_stats.allocations_nb > 0);
+
+        assert(reader_stats.bytes_read == std::filesystem::file_size(path));
+        assert(reader_stats.records_nb == 20);
+        assert(reader_stats.records_nb_by_type[type_nb(GBKFCore::ValueType::UINT32)] == 10);
+        assert(reader_stats.allocations_nb == 10 + 10 * 3);
+
+        reader.resetStats();
+        assert(reader.getStats().records_nb == 0);
+        (void) reader.getKeyedEntry("U", 3);
+        assert(reader.getStats().records_nb == 1);
+    }
+
+    std::filesystem::remove(path);
+
+    std::cout << "test OK > testStats\n";
+}
+
+void testKeyedColumns() {
+
+    std::vector<uint32_t> instance_ids;
+    std::vector<double> values;
+    std::vector<uint64_t> values_offsets = {0};
+    for (uint32_t i = 0; i < 1000; ++i) {
+        instance_ids.push_back(i * 2);
+        for (uint32_t j = 0; j < i % 4; ++j) {
+            values.push_back(i + j * 0.25);
+        }
+        values_offsets.push_back(values.size());
+    }
+
+    // Same bytes as a record per call
+    GBKFCoreWriter single_writer;
+    GBKFCoreWriter columns_writer;
+    for (size_t i = 0; i < instance_ids.size(); ++i) {
+        single_writer.addKeyedValuesFloat64("F", instance_ids[i],
+                                            values.data() + values_offsets[i],
+                                            static_cast<uint32_t>(values_offsets[i + 1] - values_offsets[i]));
+    }
+    single_writer.addKeyedValuesInt16("I", 7, {-1, 2});
+
+    columns_writer.addKeyedValuesColumns("F", instance_ids, values, values_offsets);
+    columns_writer.addKeyedValuesColumns<int16_t>("I", {7}, {-1, 2}, {0, 2});
+
+    const std::vector<uint8_t> bytes = columns_writer.getBytesBuffer();
+    assert(bytes == single_writer.getBytesBuffer());
+
+    const GBKFCoreReader reader(bytes);
+    assert(reader.getKeyedValuesNb() == 1001);
+
+    const GBKFCore::KeyedColumns<double> columns = reader.getKeyedColumns<double>("F");
+    assert(columns.instance_ids == instance_ids);
+    assert(columns.values == values);
+    assert(columns.values_offsets == values_offsets);
+
+    assert(reader.getKeyedColumns<int16_t>("I").values == std::vector<int16_t>({-1, 2}));
+    assert(reader.getKeyedColumns<int16_t>("missing").values_offsets == std::vector<uint64_t>({0}));
+
+    bool thrown = false;
+    try {
+        (void) reader.getKeyedColumns<float>("F");
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    thrown = false;
+    try {
+        columns_writer.addKeyedValuesColumns<int16_t>("I", {8, 9}, {1, 2}, {0, 2, 1});
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(columns_writer.getBytesBuffer() == bytes);
+
+    // A streaming buffer is flushed between the records: 10 records of 14 bytes fill it, so it is never grown
+    const std::string stream_path = "test_core_columns_stream.gbkf";
+    const std::vector<uint32_t> stream_ids(1000, 3);
+    std::vector<uint64_t> stream_offsets(stream_ids.size() + 1);
+    for (size_t i = 0; i < stream_offsets.size(); ++i) {
+        stream_offsets[i] = i;
+    }
+    const std::vector<uint32_t> stream_values(stream_ids.size(), 5);
+
+    GBKFCoreWriter memory_writer;
+    memory_writer.addKeyedValuesColumns("C", stream_ids, stream_values, stream_offsets);
+
+    GBKFCore::Stats stream_stats;
+    {
+        GBKFCoreWriter stream_writer(stream_path, 10 * (1 + GBKFCore::KEYED_VALUES_HEADER_SIZE + sizeof(uint32_t)));
+        stream_writer.addKeyedValuesColumns("C", stream_ids, stream_values, stream_offsets);
+        stream_writer.close();
+        stream_stats = stream_writer.getStats();
+    }
+    assert(!stream_stats.enabled || stream_stats.allocations_nb == 0);
+
+    std::ifstream stream_file(stream_path, std::ios::binary);
+    const std::vector<uint8_t> stream_bytes((std::istreambuf_iterator<char>(stream_file)),
+                                            std::istreambuf_iterator<char>());
+    stream_file.close();
+    assert(stream_bytes == memory_writer.getBytesBuffer());
+    std::filesystem::remove(stream_path);
+
+    std::cout << "test OK > testKeyedColumns\n";
+}
+
+void testTypedAccess() {
+
+    using GBKFCore::ValueType;
+
+    static_assert(GBKFCore::KeyedEntry::deduceValueType<float>() == ValueType::FLOAT32);
+    static_assert(std::is_same_v<GBKFCore::ValueTypeOf<ValueType::INT16>, int16_t>);
+    static_assert(GBKFCore::ValueTypeTraits<ValueType::UINT64>::value_size == 8);
+    static_assert(!GBKFCore::ValueTypeTraits<ValueType::STRING>::fixed_size);
+
+    // The typed methods write the same bytes as the named ones
+    GBKFCoreWriter named_writer;
+    named_writer.addKeyedValuesInt16("I", 1, {-3, 4});
+    named_writer.addKeyedValuesFloat64("F", 1, {0.5, 1.5});
+    named_writer.addKeyedValuesBoolean("B", 1, {true, false, true});
+    named_writer.addKeyedValuesStringUTF8("S", 1, {"x", "yz"}, 0);
+    named_writer.addKeyedValuesUInt8("U", 1, {9});
+    named_writer.addKeyedValuesBlob("L", 1, {1, 2, 3});
+
+    GBKFCoreWriter typed_writer;
+    typed_writer.addKeyedValues<int16_t>("I", 1, {-3, 4});
+    typed_writer.addKeyedValues<double>("F", 1, {0.5, 1.5});
+    typed_writer.addKeyedValues<bool>("B", 1, {true, false, true});
+    typed_writer.addKeyedValues<std::string>("S", 1, {"x", "yz"});
+    const uint8_t uint8_values[] = {9};
+    typed_writer.addKeyedValues("U", 1, uint8_values, 1);
+    typed_writer.addKeyedValuesBlob("L", 1, {1, 2, 3});
+
+    const std::vector<uint8_t> bytes = typed_writer.getBytesBuffer();
+    assert(bytes == named_writer.getBytesBuffer());
+
+    const GBKFCoreReader reader(bytes);
+    assert(reader.readValues<ValueType::INT16>("I", 1) == std::vector<int16_t>({-3, 4}));
+    assert(reader.readValues<ValueType::FLOAT64>("F", 1) == std::vector<double>({0.5, 1.5}));
+    assert(reader.readValues<ValueType::BOOLEAN>("B", 1) == std::vector<bool>({true, false, true}));
+    assert(reader.readValues<ValueType::STRING>("S", 1) == std::vector<std::string>({"x", "yz"}));
+    assert(reader.readValues<ValueType::UINT8>("U", 1) == std::vector<uint8_t>({9}));
+    assert(reader.readValues<ValueType::BLOB>("L", 1) == std::vector<uint8_t>({1, 2, 3}));
+
+    bool thrown = false;
+    try {
+        (void) reader.readValues<ValueType::UINT8>("L", 1);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // The runtime type as a compile-time constant
+    size_t fixed_sizes = 0;
+    for (const auto &record: reader.getKeyedRecords()) {
+        fixed_sizes += GBKFCore::visitValueType(record.type, [](auto value_type) {
+            return GBKFCore::ValueTypeTraits<decltype(value_type)::value>::value_size;
+        });
+    }
+    assert(fixed_sizes == 2 + 8 + 0 + 0 + 1 + 1);
+
+    std::cout << "test OK > testTypedAccess\n";
+}
+
+void testSchema() {
+
+    struct Frame {
+        uint32_t id = 0;
+        double time = 0;
+        std::string name;
+        std::vector<float> samples;
+        std::vector<bool> flags;
+    };
+
+    GBKFCoreWriter writer;
+    writer.setSpecificationId(42);
+    writer.setSpecificationVersion(3);
+    for (uint32_t i = 0; i < 100; ++i) {
+        writer.addKeyedValuesFloat64("T", i, {i * 0.1});
+        writer.addKeyedValuesStringUTF8("N", i, {"frame" + std::to_string(i)}, 0);
+        writer.addKeyedValuesFloat32("S", i, std::vector<float>(i % 5, static_cast<float>(i)));
+        writer.addKeyedValuesBoolean("B", i, {i % 2 == 0, true});
+    }
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+
+    GBKFCoreSchema<Frame> schema(42, 3);
+    schema.setInstanceIdField(&Frame::id)
+          .addField("T", &Frame::time)
+          .addField("N", &Frame::name)
+          .addField("S", &Frame::samples)
+          .addField("B", &Frame::flags);
+
+    const std::vector<Frame> frames = schema.decode(reader);
+    assert(frames.size() == 100);
+    assert(frames[7].id == 7);
+    assert(frames[7].time == 7 * 0.1);
+    assert(frames[7].name == "frame7");
+    assert(frames[7].samples == std::vector<float>(2, 7.0f));
+    assert(frames[7].flags == std::vector<bool>({false, true}));
+
+    // All the frames as columns
+    Frame columns;
+    schema.decodeColumns(reader, columns);
+    assert(columns.id == 99);
+    assert(columns.samples.size() == 20 * (0 + 1 + 2 + 3 + 4));
+    assert(columns.samples.capacity() == columns.samples.size()); // Reserved once from the record headers
+    assert(columns.flags.size() == 200);
+
+    // Registry by specification version
+    GBKFCoreSchemaRegistry<Frame> registry;
+    registry.add(schema);
+    assert(registry.decode(reader).size() == 100);
+
+    bool thrown = false;
+    try {
+        (void) GBKFCoreSchemaRegistry<Frame>().decode(reader);
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // The layout must match every record
+    for (int i = 0; i < 2; ++i) {
+        GBKFCoreSchema<Frame> wrong_schema(42, 3);
+        wrong_schema.addField("T", &Frame::time).addField(i == 0 ? "X" : "N", &Frame::name);
+        if (i == 1) {
+            wrong_schema.addField("S", &Frame::samples).addField("S", &Frame::samples);
+        }
+
+        thrown = false;
+        try {
+            (void) wrong_schema.decode(reader);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    std::cout << "test OK > testSchema\n";
+}
+
+void testIndexBlock() {
+
+    const std::string memory_path = "test_core_index_memory.gbkf";
+    const std::string stream_path = "test_core_index_stream.gbkf";
+    const std::string async_path = "test_core_index_async.gbkf";
+
+    GBKFCoreWriter plain_writer;
+    GBKFCoreWriter memory_writer;
+    memory_writer.setIndexBlock();
+    {
+        GBKFCoreWriter stream_writer(stream_path, 256);
+        GBKFCoreWriter async_writer(async_path, 256, 2);
+        stream_writer.setIndexBlock();
+        async_writer.setIndexBlock();
+
+        const uint32_t instance_ids[] = {0, 1, 2};
+        const uint32_t values[] = {10, 11, 12, 13};
+        const uint64_t values_offsets[] = {0, 1, 3, 4};
+
+        for (auto *writer: {&plain_writer, &memory_writer, &stream_writer, &async_writer}) {
+            for (uint32_t i = 0; i < 100; ++i) {
+                writer->addKeyedValuesUInt64("U", i, {i, i * 2ULL});
+                writer->addKeyedValuesStringUTF8("S", i, {"index", std::to_string(i)}, 0);
+            }
+            writer->addKeyedValuesColumns<uint32_t>("C", instance_ids, 3, values, values_offsets);
+            writer->addKeyedValuesBoolean("B", 7, {true, false, true});
+        }
+
+        stream_writer.close();
+        async_writer.closeAsync().get();
+    }
+    memory_writer.write(memory_path);
+
+    bool index_block_after_records = false;
+    try {
+        memory_writer.setIndexBlock(false);
+    } catch (const std::runtime_error &) {
+        index_block_after_records = true;
+    }
+    assert(index_block_after_records);
+
+    const GBKFCoreReader plain_reader(plain_writer.getBytesBuffer());
+    assert(!plain_reader.hasIndexBlock());
+
+    const std::vector<uint8_t> buffer = memory_writer.getBytesBuffer();
+    assert(buffer == memory_writer.takeBytesBuffer());
+    assert(buffer.size() > plain_writer.getBytesBuffer().size());
+
+    for (const auto &path: {memory_path, stream_path, async_path}) {
+        const GBKFCoreReader reader(path);
+        assert(reader.hasIndexBlock());
+        assert(reader.verifiesSha());
+        assert(reader.getKeyedValuesNb() == 204);
+
+        // Found without scanning the records
+        assert(reader.getKeyedEntry("U", 42).getValues<uint64_t>() == std::vector<uint64_t>({42, 84}));
+        assert(reader.getStringViews("S", 99)[1] == "99");
+        assert(reader.readValues<GBKFCore::ValueType::UINT32>("C", 1) == std::vector<uint32_t>({11, 12}));
+        assert(reader.getValuesView<uint32_t>("C", 2)[0] == 13);
+        assert(reader.getKeyedEntry("B", 7).getValues<bool>() == std::vector<bool>({true, false, true}));
+        assert(!reader.hasKeyedEntry("U", 100));
+        assert(!reader.hasKeyedEntry("X", 0));
+
+        // The records scanned as before
+        assert(reader.getKeyedRecords().size() == plain_reader.getKeyedRecords().size());
+        assert(reader.getKeyedEntries().at("C").size() == 3);
+        assert(reader.hasKeyedEntry("U", 0));
+
+        std::ifstream file(path, std::ios::binary);
+        GBKFCoreStreamReader stream_reader(file);
+        uint32_t records_nb = 0;
+        while (stream_reader.nextRecord()) {
+            ++records_nb;
+        }
+        assert(records_nb == 204);
+        assert(stream_reader.verifiesSha());
+    }
+
+    // Without footer
+    GBKFCoreWriter no_footer_writer;
+    no_footer_writer.setIndexBlock();
+    no_footer_writer.addKeyedValuesInt8("I", 3, {-1, 2});
+    const GBKFCoreReader no_footer_reader(no_footer_writer.getBytesBuffer(true, false));
+    assert(no_footer_reader.hasIndexBlock());
+    assert(no_footer_reader.getKeyedEntry("I", 3).getValues<int8_t>() == std::vector<int8_t>({-1, 2}));
+
+    // A record and its entry extended over the index block, which starts where the record ended
+    std::vector<uint8_t> overlapping_buffer = no_footer_writer.getBytesBuffer(true, false);
+    const uint64_t trailer_pos = overlapping_buffer.size() - GBKFCore::IndexBlock::TRAILER_SIZE;
+    uint64_t index_start;
+    std::memcpy(&index_start, overlapping_buffer.data() + trailer_pos, 8);
+    overlapping_buffer[GBKFCore::Header::SIZE + 1 + 4 + 1] += 8; // Values number of the record
+    overlapping_buffer[index_start + 1 + 4 + 8] += 8;            // Length of its entry
+
+    const GBKFCoreReader overlapping_reader(overlapping_buffer);
+    assert(overlapping_reader.hasIndexBlock());
+
+    bool entry_out_of_bounds = false;
+    try {
+        (void) overlapping_reader.getKeyedEntry("I", 3);
+    } catch (const std::runtime_error &error) {
+        entry_out_of_bounds = std::string(error.what()) == "Index block entry out of bounds";
+    }
+    assert(entry_out_of_bounds);
+
+    // The keys are cut to the keys size the same way, with or without the index block
+    for (const bool index_block: {true, false}) {
+        GBKFCoreWriter short_keys_writer;
+        short_keys_writer.setKeysSize(2);
+        short_keys_writer.setIndexBlock(index_block);
+        short_keys_writer.addKeyedValuesUInt32("AB", 1, {4, 5});
+
+        const GBKFCoreReader short_keys_reader(short_keys_writer.getBytesBuffer());
+        assert(short_keys_reader.hasIndexBlock() == index_block);
+        assert(short_keys_reader.getKeyedEntry("ABC", 1).getValues<uint32_t>() == std::vector<uint32_t>({4, 5}));
+        assert(short_keys_reader.hasKeyedEntry(std::string("AB\0C", 4), 1));
+        assert(!short_keys_reader.hasKeyedEntry("A", 1));
+    }
+
+    std::filesystem::remove(memory_path);
+    std::filesystem::remove(stream_path);
+    std::filesystem::remove(async_path);
+
+    std::cout << "test OK > testIndexBlock\n";
+}
+
+void testCompression() {
+
+    GBKFCoreWriter writer;
+
+    bool invalid_chunk_size = false;
+    try {
+        writer.setCompression(GBKFCore::Compression::NONE, 0, 0);
+    } catch (const std::invalid_argument &) {
+        invalid_chunk_size = true;
+    }
+    assert(invalid_chunk_size);
+
+    GBKFCore::Compression compression = GBKFCore::Compression::NONE;
+    for (const auto codec: {GBKFCore::Compression::ZSTD, GBKFCore::Compression::LZ4, GBKFCore::Compression::ZLIB}) {
+        if (GBKFCore::Codecs::isAvailable(codec)) {
+            compression = codec;
+        } else {
+            bool unavailable = false;
+            try {
+                writer.setCompression(codec);
+            } catch (const std::invalid_argument &) {
+                unavailable = true;
+            }
+            assert(unavailable);
+        }
+    }
+
+    if (compression == GBKFCore::Compression::NONE) {
+        std::cout << "test OK > testCompression (no codec in this build)\n";
+        return;
+    }
+
+    const std::string path = "test_core_compression.gbkf";
+
+    std::vector<double> input_floats(10000);
+    for (size_t i = 0; i < input_floats.size(); ++i) {
+        input_floats[i] = static_cast<double>(i % 100) * 0.25;
+    }
+    const std::vector<std::string> input_strings(300, "compressed string");
+    std::vector<bool> input_bools(5000);
+    for (size_t i = 0; i < input_bools.size(); ++i) {
+        input_bools[i] = i % 4 == 0;
+    }
+    const std::vector<uint32_t> input_ints(100, 7);
+
+    GBKFCoreWriter raw_writer;
+    writer.setIndexBlock();
+    for (auto *current_writer: {&raw_writer, &writer}) {
+        if (current_writer == &writer) {
+            // Small chunks, so the values are decompressed on several threads
+            writer.setCompression(compression, 0, 1024);
+        }
+        current_writer->addKeyedValuesFloat64("F", 0, input_floats);
+        current_writer->addKeyedValuesStringUTF8("S", 0, input_strings, 0);
+        current_writer->addKeyedValuesBoolean("B", 0, input_bools);
+        current_writer->addKeyedValuesUInt32("C", 0, input_ints);
+        current_writer->addKeyedValuesUInt32("C", 1, input_ints);
+        current_writer->addKeyedValuesUInt8("U", 0, {1, 2, 3});
+    }
+    writer.write(path);
+
+    const std::vector<uint8_t> buffer = writer.getBytesBuffer();
+    assert(buffer.size() < raw_writer.getBytesBuffer().size());
+
+    // The records too small to compress stay as they are
+    const GBKFCoreReader reader(path);
+    assert(reader.hasIndexBlock());
+    assert(reader.verifiesSha());
+    assert(reader.getKeyedEntry("F", 0).getValues<double>() == input_floats);
+    assert(reader.readValues<GBKFCore::ValueType::STRING>("S", 0) == input_strings);
+    assert(reader.getKeyedEntry("B", 0).getValues<bool>() == input_bools);
+    assert(reader.getValuesView<uint8_t>("U", 0)[2] == 3);
+
+    bool no_view = false;
+    try {
+        (void) reader.getValuesView<double>("F", 0);
+    } catch (const std::runtime_error &) {
+        no_view = true;
+    }
+    assert(no_view);
+
+    const GBKFCore::KeyedColumns<uint32_t> columns = reader.getKeyedColumns<uint32_t>("C");
+    assert(columns.values.size() == 200 && columns.values[199] == 7);
+
+    const auto &records = reader.getKeyedRecords();
+    assert(records[0].compressed && records[0].type == GBKFCore::ValueType::FLOAT64);
+    assert(!records[5].compressed);
+
+    auto keyed_entries = reader.getKeyedEntries(4);
+    assert(keyed_entries["S"][0].getValues<std::string>() == input_strings);
+    assert(keyed_entries["C"][1].getValues<uint32_t>() == input_ints);
+
+    std::ifstream file(path, std::ios::binary);
+    GBKFCoreStreamReader stream_reader(file);
+    while (stream_reader.nextRecord()) {
+        if (stream_reader.getRecord().key == "F") {
+            assert(stream_reader.readEntry().getValues<double>() == input_floats);
+        } else if (stream_reader.getRecord().key == "S") {
+            assert(stream_reader.readStringViews()[299] == "compressed string");
+        }
+    }
+    assert(stream_reader.verifiesSha());
+
+    // Corrupted chunk size
+    std::vector<uint8_t> corrupted_buffer = buffer;
+    std::fill_n(corrupted_buffer.begin() + static_cast<std::ptrdiff_t>(records[0].values_pos + 1 + 8 + 8), 4, 0);
+    const GBKFCoreReader corrupted_reader(corrupted_buffer);
+
+    bool corrupted = false;
+    try {
+        (void) corrupted_reader.getKeyedEntry("F", 0);
+    } catch (const std::runtime_error &) {
+        corrupted = true;
+    }
+    assert(corrupted);
+
+    std::filesystem::remove(path);
+
+    std::cout << "test OK > testCompression\n";
+}
+
+void testDeltaCompression() {
+
+    const std::string path = "test_core_delta.gbkf";
+
+    std::vector<int64_t> timestamps(10001);
+    std::vector<uint32_t> counters(3000);
+    std::vector<int8_t> decreasing(999);
+    std::vector<uint64_t> hashes(257);
+    std::vector<int16_t> wrapping(130);
+
+    uint64_t seed = 42;
+    const auto next_random = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return seed;
+    };
+
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        timestamps[i] = 1700000000000LL + static_cast<int64_t>(i) * 1000 + static_cast<int64_t>(next_random() % 7);
+    }
+    for (size_t i = 0; i < counters.size(); ++i) {
+        counters[i] = static_cast<uint32_t>(next_random() % 16);
+    }
+    for (size_t i = 0; i < decreasing.size(); ++i) {
+        decreasing[i] = static_cast<int8_t>(100 - static_cast<int>(i));
+    }
+    for (auto &hash: hashes) {
+        hash = next_random();
+    }
+    for (size_t i = 0; i < wrapping.size(); ++i) {
+        wrapping[i] = static_cast<int16_t>(i % 2 == 0 ? INT16_MAX : INT16_MIN);
+    }
+    const std::vector<double> input_floats(100, 1.5);
+
+    bool invalid_chunk_size = false;
+    try {
+        GBKFCoreWriter().setCompression(GBKFCore::Compression::DELTA, 0, 1001);
+    } catch (const std::invalid_argument &) {
+        invalid_chunk_size = true;
+    }
+    assert(invalid_chunk_size);
+
+    GBKFCoreWriter raw_writer;
+    GBKFCoreWriter writer;
+    writer.setCompression(GBKFCore::Compression::DELTA, 0, 4096);
+
+    for (auto *current_writer: {&raw_writer, &writer}) {
+        current_writer->addKeyedValuesInt64("T", 0, timestamps);
+        current_writer->addKeyedValuesUInt32("C", 0, counters);
+        current_writer->addKeyedValuesInt8("D", 0, decreasing);
+        current_writer->addKeyedValuesUInt64("H", 0, hashes);
+        current_writer->addKeyedValuesInt16("W", 0, wrapping);
+        current_writer->addKeyedValuesFloat64("F", 0, input_floats);
+    }
+    writer.write(path);
+
+    // The timestamps take about 2 bytes per value
+    assert(writer.getBytesBuffer().size() * 3 < raw_writer.getBytesBuffer().size());
+
+    const GBKFCoreReader reader(path);
+    assert(reader.verifiesSha());
+
+    const auto &records = reader.getKeyedRecords();
+    assert(records[0].compressed && records[1].compressed && records[2].compressed);
+    assert(!records[3].compressed); // The random values do not get smaller
+    assert(!records[5].compressed); // Only the integers are encoded
+
+    assert(reader.getKeyedEntry("T", 0).getValues<int64_t>() == timestamps);
+    assert(reader.readValues<GBKFCore::ValueType::UINT32>("C", 0) == counters);
+    assert(reader.getKeyedEntry("D", 0).getValues<int8_t>() == decreasing);
+    assert(reader.getKeyedEntry("H", 0).getValues<uint64_t>() == hashes);
+    assert(reader.getKeyedEntry("W", 0).getValues<int16_t>() == wrapping);
+    assert(reader.getKeyedEntries(2)["T"][0].getValues<int64_t>() == timestamps);
+
+    // The SIMD and portable kernels give the same values, for every bit width
+    for (const uint8_t bits_nb: {0, 1, 3, 8, 13, 31, 32, 33, 50, 57}) {
+        std::vector<uint64_t> values(103);
+        for (size_t i = 1; i < values.size(); ++i) {
+            const uint64_t zigzag = bits_nb == 0 ? 0 : next_random() >> (64 - bits_nb);
+            values[i] = values[i - 1] + GBKFCore::Delta::unzigzag(zigzag);
+        }
+
+        const auto *source = reinterpret_cast<const uint8_t *>(values.data());
+        const uint64_t size = values.size() * 8;
+        std::vector<uint8_t> encoded(GBKFCore::Delta::compressBound(size, 8));
+        encoded.resize(GBKFCore::Delta::encode(source, size, 8, encoded.data(), encoded.size()));
+        assert(encoded[8] <= bits_nb);
+
+        std::vector<uint64_t> decoded(values.size());
+        GBKFCore::Delta::decode(encoded.data(), encoded.size(), 8, reinterpret_cast<uint8_t *>(decoded.data()), size);
+        assert(decoded == values);
+
+        std::vector<uint64_t> portable_decoded(values.size());
+        portable_decoded[0] = values[0];
+        GBKFCore::Delta::decodePortable(encoded.data() + GBKFCore::Delta::CHUNK_HEADER_SIZE, 1, values.size(),
+                                        encoded[8], values[0],
+                                        reinterpret_cast<uint8_t *>(portable_decoded.data()), 8);
+        assert(portable_decoded == values);
+    }
+
+    std::filesystem::remove(path);
+
+    std::cout << "test OK > testDeltaCompression\n";
+}
+
+void testBitmaps() {
+
+    // Sizes around the 8 and 16 values blocks of the kernels
+    for (const uint32_t values_nb: {0u, 1u, 7u, 8u, 15u, 16u, 17u, 100u, 1003u, 2500u}) {
+        std::unique_ptr<bool[]> values(new bool[values_nb]);
+        std::vector<bool> input_bools(values_nb);
+        for (uint32_t i = 0; i < values_nb; ++i) {
+            values[i] = (i * 7) % 3 == 0;
+            input_bools[i] = values[i];
+        }
+
+        std::vector<uint8_t> packed(GBKFCore::Bitmap::bytesNb(values_nb));
+        GBKFCore::Bitmap::pack(values.get(), values_nb, packed.data());
+
+        GBKFCoreWriter writer;
+        writer.addKeyedValuesBoolean("B", 0, input_bools);
+        writer.addKeyedValuesBoolean("A", 0, values.get(), values_nb);
+        writer.addKeyedValuesBitmap("P", 0, packed.data(), values_nb);
+
+        const GBKFCoreReader reader(writer.getBytesBuffer());
+        for (const std::string key: {"B", "A", "P"}) {
+            assert(reader.getKeyedEntry(key, 0).getValues<bool>() == input_bools);
+
+            const GBKFCore::BitmapView view = reader.getBitmapView(key, 0);
+            assert(view.size() == values_nb);
+            assert(view.bytesNb() == packed.size());
+            assert(std::equal(packed.begin(), packed.end(), view.bytes()));
+            assert(view.toVector() == input_bools);
+            assert(view.count() == static_cast<uint64_t>(std::count(input_bools.begin(), input_bools.end(), true)));
+
+            std::unique_ptr<bool[]> unpacked(new bool[values_nb]);
+            view.unpack(unpacked.get());
+            assert(std::equal(unpacked.get(), unpacked.get() + values_nb, values.get()));
+        }
+    }
+
+    // The bits after the last value are not written
+    const uint8_t packed[] = {0xFF, 0xFF};
+    GBKFCoreWriter writer;
+    writer.addKeyedValuesBitmap("P", 0, packed, 11);
+    writer.addKeyedValuesUInt8("U", 0, {1});
+
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+    const GBKFCore::BitmapView view = reader.getBitmapView("P", 0);
+    assert(view.count() == 11 && view.bytes()[1] == 0x07);
+
+    bool type_mismatch = false;
+    try {
+        (void) reader.getBitmapView("U", 0);
+    } catch (const std::runtime_error &) {
+        type_mismatch = true;
+    }
+    assert(type_mismatch);
+
+    // The booleans number of the last byte must match the values number
+    std::vector<uint8_t> malformed_bytes = writer.getBytesBuffer(true, false);
+    const uint64_t last_byte_bools_pos = GBKFCore::Header::SIZE + 1 + GBKFCore::KEYED_VALUES_HEADER_SIZE;
+    assert(malformed_bytes[last_byte_bools_pos] == 3);
+    malformed_bytes[last_byte_bools_pos] = 8;
+
+    bool malformed = false;
+    try {
+        (void) GBKFCoreReader(malformed_bytes).getKeyedEntry("P", 0);
+    } catch (const std::invalid_argument &) {
+        malformed = true;
+    }
+    assert(malformed);
+
+    std::cout << "test OK > testBitmaps\n";
+}
+
+void testAppend() {
+
+    const std::string append_path = "test_core_append.gbkf";
+    const std::string memory_path = "test_core_append_memory.gbkf";
+
+    std::vector<uint64_t> input_times(1000);
+    for (size_t i = 0; i < input_times.size(); ++i) {
+        input_times[i] = 1700000000 + i * 60;
+    }
+
+    const auto read_file = [](const std::string &path) {
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(std::ifstream(path, std::ios::binary).rdbuf()),
+                                    std::istreambuf_iterator<char>());
+    };
+
+    // The records of the writer, in the batches of rounds first to rounds last (excluded)
+    const auto add_records = [&input_times](GBKFCoreWriter &writer, const uint32_t first, const uint32_t last) {
+        for (uint32_t round = first; round < last; ++round) {
+            writer.addKeyedValuesUInt64("T", round, input_times);
+            writer.addKeyedValuesStringUTF8("S", round, {"round", std::to_string(round)});
+            writer.addKeyedValuesBoolean("B", round, std::vector<bool>(round + 3, true));
+        }
+    };
+
+    for (const bool index_block: {false, true}) {
+        for (const uint32_t async_buffers_nb: {0u, 2u}) {
+            GBKFCoreWriter memory_writer;
+            GBKFCoreWriter first_writer;
+            for (auto *writer: {&memory_writer, &first_writer}) {
+                writer->setSpecificationId(7);
+                writer->setIndexBlock(index_block);
+                writer->setCompression(GBKFCore::Compression::DELTA);
+            }
+
+            add_records(memory_writer, 0, 10);
+            memory_writer.write(memory_path);
+
+            add_records(first_writer, 0, 4);
+            first_writer.write(append_path);
+
+            // Two appends, with a small buffer so the new records are flushed many times
+            for (const auto &[first, last]: {std::make_pair(4u, 7u), std::make_pair(7u, 10u)}) {
+                GBKFCoreWriter append_writer = GBKFCoreWriter::openAppend(append_path, 256, async_buffers_nb);
+                assert(append_writer.isStreaming());
+                append_writer.setCompression(GBKFCore::Compression::DELTA);
+                add_records(append_writer, first, last);
+                append_writer.close();
+            }
+
+            // The appended file is identical to the one written at once
+            assert(read_file(append_path) == read_file(memory_path));
+
+            const GBKFCoreReader reader(append_path);
+            assert(reader.verifiesSha());
+            assert(reader.getSpecificationID() == 7);
+            assert(reader.getKeyedValuesNb() == 30);
+            assert(reader.hasIndexBlock() == index_block);
+            assert(reader.getKeyedEntry("T", 2).getValues<uint64_t>() == input_times);
+            assert(reader.getKeyedEntry("T", 9).getValues<uint64_t>() == input_times);
+            assert(reader.getKeyedEntry("S", 8).getValues<std::string>()[1] == "8");
+
+            // The keys of the existing records fix the keys size
+            GBKFCoreWriter keys_writer = GBKFCoreWriter::openAppend(append_path, 256, async_buffers_nb);
+            keys_writer.setKeysSize(1);
+
+            bool keys_size_mismatch = false;
+            try {
+                keys_writer.setKeysSize(2);
+            } catch (const std::invalid_argument &) {
+                keys_size_mismatch = true;
+            }
+            assert(keys_size_mismatch);
+            keys_writer.close();
+            assert(read_file(append_path) == read_file(memory_path));
+        }
+    }
+
+    // Without new records nor footer, the file is truncated after the index block
+    const uint64_t indexed_size = std::filesystem::file_size(append_path);
+    GBKFCoreWriter::openAppend(append_path).close(true, false);
+    assert(std::filesystem::file_size(append_path) == indexed_size - GBKFCore::FOOTER_SIZE);
+
+    const GBKFCoreReader truncated_reader(append_path);
+    assert(truncated_reader.hasIndexBlock());
+    assert(truncated_reader.getKeyedEntry("B", 4).getValues<bool>() == std::vector<bool>(7, true));
+
+    // A file that does not match its footer is not changed
+    for (const bool index_block: {false, true}) {
+        GBKFCoreWriter corrupted_writer;
+        corrupted_writer.setIndexBlock(index_block);
+        corrupted_writer.addKeyedValuesUInt64("T", 1, input_times);
+        corrupted_writer.write(append_path);
+
+        std::vector<uint8_t> corrupted_bytes = read_file(append_path);
+        corrupted_bytes[GBKFCore::Header::SIZE + 1 + GBKFCore::KEYED_VALUES_HEADER_SIZE] ^= 0x01;
+        std::ofstream(append_path, std::ios::binary)
+            .write(reinterpret_cast<const char *>(corrupted_bytes.data()),
+                   static_cast<std::streamsize>(corrupted_bytes.size()));
+
+        bool footer_mismatch = false;
+        try {
+            (void) GBKFCoreWriter::openAppend(append_path);
+        } catch (const std::runtime_error &) {
+            footer_mismatch = true;
+        }
+        assert(footer_mismatch);
+        assert(read_file(append_path) == corrupted_bytes);
+    }
+
+    bool missing_file = false;
+    try {
+        (void) GBKFCoreWriter::openAppend("test_core_append_missing.gbkf");
+    } catch (const std::runtime_error &) {
+        missing_file = true;
+    }
+    assert(missing_file);
+
+    std::filesystem::remove(append_path);
+    std::filesystem::remove(memory_path);
+
+    std::cout << "test OK > testAppend\n";
+}
+
+template<typename T>
+void checkFixedWidthDecode(const uint32_t values_nb) {
+    std::vector<T> input_values(values_nb);
+    for (uint32_t i = 0; i < values_nb; ++i) {
+        input_values[i] = static_cast<T>(i * 37 + 11);
+    }
+    if (values_nb >= 2) {
+        input_values.front() = std::numeric_limits<T>::lowest();
+        input_values.back() = std::numeric_limits<T>::max();
+    }
+
+    GBKFCoreWriter writer;
+    writer.setKeysSize(3);
+    for (uint32_t id = 0; id < 3; ++id) {
+        // The odd blobs before the values keep them unaligned
+        writer.addKeyedValuesBlob("PAD", id, std::vector<uint8_t>(id + 1, 0xAB));
+        writer.addKeyedValues<T>("VAL", id, input_values);
+    }
+
+    constexpr GBKFCore::ValueType value_type = GBKFCore::KeyedEntry::deduceValueType<T>();
+    const GBKFCoreReader reader(writer.getBytesBuffer());
+    for (uint32_t id = 0; id < 3; ++id) {
+        assert(reader.getKeyedEntry("VAL", id).getValues<T>() == input_values);
+        assert(reader.readValues<value_type>("VAL", id) == input_values);
+    }
+
+    const auto keyed_entries = reader.getKeyedEntries(2);
+    for (const auto &entry: keyed_entries.at("VAL")) {
+        assert(entry.getValues<T>() == input_values);
+    }
+}
+
+void testFixedWidthDecode() {
+
+    // Sizes around the lengths copied at once
+    for (const uint32_t values_nb: {0u, 1u, 2u, 3u, 1001u}) {
+        checkFixedWidthDecode<int8_t>(values_nb);
+        checkFixedWidthDecode<int16_t>(values_nb);
+        checkFixedWidthDecode<int32_t>(values_nb);
+        checkFixedWidthDecode<int64_t>(values_nb);
+        checkFixedWidthDecode<uint8_t>(values_nb);
+        checkFixedWidthDecode<uint16_t>(values_nb);
+        checkFixedWidthDecode<uint32_t>(values_nb);
+        checkFixedWidthDecode<uint64_t>(values_nb);
+        checkFixedWidthDecode<float>(values_nb);
+        checkFixedWidthDecode<double>(values_nb);
+    }
+
+    std::cout << "test OK > testFixedWidthDecode\n";
+}
+
 int main() {
 
     testHeader();
@@ -389,6 +2048,35 @@ int main() {
     testStringBufferSize3();
     testStringBufferSize4();
     testStringBufferSize5();
+    testReaderSources();
+    testIndexedAccess();
+    testShaVerification();
+    testSha256();
+    testStreamingWriter();
+    testStreamReader();
+    testValuesView();
+    testParallelDecode();
+    testKeyedEntryValues();
+    testMemoryResource();
+    testStringViews();
+    testKeysRegistry();
+    testStringsBounds();
+    testContiguousValues();
+    testTakeBytesBuffer();
+    testIncrementalFooter();
+    testOpenMany();
+    testAsyncStreamingWriter();
+    testFilteredDecode();
+    testStats();
+    testKeyedColumns();
+    testTypedAccess();
+    testSchema();
+    testIndexBlock();
+    testCompression();
+    testDeltaCompression();
+    testBitmaps();
+    testAppend();
+    testFixedWidthDecode();
 
     return 0;
 }